@@ -14,54 +14,1250 @@
 #define _HIGH	1
 #define _LOW	0
 
+#define _ENV_OFF		0
+#define _ENV_ATTACK		1
+#define _ENV_DECAY		2
+#define _ENV_SUSTAIN	3
+#define _ENV_RELEASE	4
+
+#define _DUTY_DEFAULT	50
+
+#define _OUT_FREQ		0x01
+#define _OUT_DUTY		0x02
+#define _OUT_GPIO		0x04
+
+// compile time specialization, see the configuration of buzzer.h
+
+#if BUZZER_STATIC_TYPE == BUZZER_STATIC_ACTIVE
+#define _IS_ACTIVE(buzzer)		1
+#define _IS_PASSIVE(buzzer)		0
+#elif BUZZER_STATIC_TYPE == BUZZER_STATIC_PASSIVE
+#define _IS_ACTIVE(buzzer)		0
+#define _IS_PASSIVE(buzzer)		1
+#else
+#define _IS_ACTIVE(buzzer)		((buzzer)->type == BUZZER_TYPE_ACTIVE)
+#define _IS_PASSIVE(buzzer)		((buzzer)->type == BUZZER_TYPE_PASSIVE)
+#endif
+
+#if BUZZER_STATIC_INTERRUPT_MS
+#define _TICK_MS(buzzer)		BUZZER_STATIC_INTERRUPT_MS
+#else
+#define _TICK_MS(buzzer)		((buzzer)->interruptMs)
+#endif
+
+#ifdef BUZZER_PWM_OUT
+#define _HAS_PWM(buzzer)		1
+#define _PWM_OUT(buzzer, freq)	BUZZER_PWM_OUT(freq)
+#else
+#define _HAS_PWM(buzzer)		((buzzer)->fnx.pwmOut != NULL)
+#define _PWM_OUT(buzzer, freq)	(buzzer)->fnx.pwmOut(freq)
+#endif
+
+#ifdef BUZZER_DUTY_OUT
+#define _HAS_DUTY(buzzer)		1
+#define _DUTY_OUT(buzzer, duty)	BUZZER_DUTY_OUT(duty)
+#else
+#define _HAS_DUTY(buzzer)		((buzzer)->fnx.pwmDutyOut != NULL)
+#define _DUTY_OUT(buzzer, duty)	(buzzer)->fnx.pwmDutyOut(duty)
+#endif
+
+#ifdef BUZZER_GPIO_OUT
+#define _HAS_GPIO(buzzer)		1
+#define _GPIO_OUT(buzzer, val)	BUZZER_GPIO_OUT(val)
+#else
+#define _HAS_GPIO(buzzer)		((buzzer)->fnx.gpioOut != NULL)
+#define _GPIO_OUT(buzzer, val)	(buzzer)->fnx.gpioOut(val)
+#endif
+
+// the type of buzzer_init(), from the outputs
+#if BUZZER_STATIC_TYPE == BUZZER_STATIC_ACTIVE
+#define _DETECT_ACTIVE(buzzer)	_HAS_GPIO(buzzer)
+#define _DETECT_PASSIVE(buzzer)	0
+#elif BUZZER_STATIC_TYPE == BUZZER_STATIC_PASSIVE
+#define _DETECT_ACTIVE(buzzer)	0
+#define _DETECT_PASSIVE(buzzer)	_HAS_PWM(buzzer)
+#else
+#define _DETECT_ACTIVE(buzzer)	_HAS_GPIO(buzzer)
+#define _DETECT_PASSIVE(buzzer)	_HAS_PWM(buzzer)
+#endif
+
+#if BUZZER_USE_SOFTPWM
+#define _SOFTPWM_ON(buzzer)		((buzzer)->softpwm.hz != 0)
+#else
+#define _SOFTPWM_ON(buzzer)		0
+#endif
+
+#if BUZZER_USE_LFO
+#define _TREM_GAIN(buzzer)		((buzzer)->lfo.tremGain)
+#else
+#define _TREM_GAIN(buzzer)		0xFF
+#endif
+
+#define _SFX_ATTACK		0
+#define _SFX_SUSTAIN	1
+#define _SFX_DECAY		2
+#define _SFX_MS_UNIT	8
+
 /**
  * privates
  */
 
+#if BUZZER_USE_TRACE
+static uint8_t _traceIds;
+#endif
+
+// instances playing, for the idle and wake callbacks
+static volatile uint32_t _activeCount;
+
+#if BUZZER_USE_ENVELOPE
+// envelope curves, rising and falling exponentials
+static const uint8_t _envRise[BUZZER_ENV_LEN] = {
+	  0,  24,  46,  66,  84, 100, 115, 129,
+	142, 153, 163, 173, 181, 189, 196, 203,
+	208, 214, 219, 223, 227, 231, 234, 237,
+	240, 243, 245, 247, 249, 251, 252, 254
+};
+#endif
 
+#if BUZZER_USE_SOFTPWM
+// soft PWM patterns, the bits of each level are evenly spread
+static const uint32_t _softpwmPattern[BUZZER_SOFTPWM_LEVELS] = {
+	0x00000000, 0x80808080, 0x88888888, 0xA4A4A4A4,
+	0xAAAAAAAA, 0xDADADADA, 0xEEEEEEEE, 0xFEFEFEFE,
+	0xFFFFFFFF
+};
+#endif
+
+#if BUZZER_USE_PACKED
+// pitches of the packed melodies, in semitones from NOTE_B0
+static const uint16_t _packedPitch[BUZZER_PACKED_PITCHES] = {
+	NOTE_OFF, NOTE_B0, NOTE_C1, NOTE_CS1, NOTE_D1, NOTE_DS1,
+	NOTE_E1, NOTE_F1, NOTE_FS1, NOTE_G1, NOTE_GS1, NOTE_A1,
+	NOTE_AS1, NOTE_B1, NOTE_C2, NOTE_CS2, NOTE_D2, NOTE_DS2,
+	NOTE_E2, NOTE_F2, NOTE_FS2, NOTE_G2, NOTE_GS2, NOTE_A2,
+	NOTE_AS2, NOTE_B2, NOTE_C3, NOTE_CS3, NOTE_D3, NOTE_DS3,
+	NOTE_E3, NOTE_F3, NOTE_FS3, NOTE_G3, NOTE_GS3, NOTE_A3,
+	NOTE_AS3, NOTE_B3, NOTE_C4, NOTE_CS4, NOTE_D4, NOTE_DS4,
+	NOTE_E4, NOTE_F4, NOTE_FS4, NOTE_G4, NOTE_GS4, NOTE_A4,
+	NOTE_AS4, NOTE_B4, NOTE_C5, NOTE_CS5, NOTE_D5, NOTE_DS5,
+	NOTE_E5, NOTE_F5, NOTE_FS5, NOTE_G5, NOTE_GS5, NOTE_A5,
+	NOTE_AS5, NOTE_B5, NOTE_C6, NOTE_CS6, NOTE_D6, NOTE_DS6,
+	NOTE_E6, NOTE_F6, NOTE_FS6, NOTE_G6, NOTE_GS6, NOTE_A6,
+	NOTE_AS6, NOTE_B6, NOTE_C7, NOTE_CS7, NOTE_D7, NOTE_DS7,
+	NOTE_E7, NOTE_F7, NOTE_FS7, NOTE_G7, NOTE_GS7, NOTE_A7,
+	NOTE_AS7, NOTE_B7, NOTE_C8, NOTE_CS8, NOTE_D8, NOTE_DS8
+};
+#endif
+
+#if BUZZER_USE_MORSE
+// Morse codes from ' ' to '_', the elements from the bit 0 (0 is a dit,
+// 1 a dah) up to a last 1 that marks the end. 0 has no code
+static const uint8_t _morseCode[64] = {
+	0x00, 0x75, 0x52, 0x00, 0xC8, 0x00, 0x22, 0x5E,	// sp ! " # $ % & '
+	0x2D, 0x6D, 0x00, 0x2A, 0x73, 0x61, 0x6A, 0x29,	// ( ) * + , - . /
+	0x3F, 0x3E, 0x3C, 0x38, 0x30, 0x20, 0x21, 0x23,	// 0 1 2 3 4 5 6 7
+	0x27, 0x2F, 0x47, 0x55, 0x00, 0x31, 0x00, 0x4C,	// 8 9 : ; < = > ?
+	0x56, 0x06, 0x11, 0x15, 0x09, 0x02, 0x14, 0x0B,	// @ A B C D E F G
+	0x10, 0x04, 0x1E, 0x0D, 0x12, 0x07, 0x05, 0x0F,	// H I J K L M N O
+	0x16, 0x1B, 0x0A, 0x08, 0x03, 0x0C, 0x18, 0x0E,	// P Q R S T U V W
+	0x19, 0x1D, 0x13, 0x00, 0x00, 0x00, 0x00, 0x6C	// X Y Z [ \ ] ^ _
+};
+#endif
+
+#if BUZZER_USE_GLIDE
+// log2(1 + i/32) and 2^(i/32), Q16, for the exponential glides
+static const uint16_t _log2Tab[33] = {
+	    0,  2909,  5732,  8473, 11136, 13727, 16248, 18704,
+	21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+	38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+	52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+	65535
+};
+
+static const uint32_t _exp2Tab[33] = {
+	 65536,  66971,  68438,  69936,  71468,  73032,  74632,  76266,
+	 77936,  79642,  81386,  83169,  84990,  86851,  88752,  90696,
+	 92682,  94711,  96785,  98905, 101070, 103283, 105545, 107856,
+	110218, 112631, 115098, 117618, 120194, 122825, 125515, 128263,
+	131072
+};
+#endif
+
+#if BUZZER_USE_LFO
+// LFO waveforms, one period each
+static const int8_t _lfoWave[3][32] = {
+	{
+		   0,   25,   49,   71,   90,  106,  117,  125,
+		 127,  125,  117,  106,   90,   71,   49,   25,
+		   0,  -25,  -49,  -71,  -90, -106, -117, -125,
+		-127, -125, -117, -106,  -90,  -71,  -49,  -25
+	},
+	{
+		   0,   16,   32,   48,   64,   79,   95,  111,
+		 127,  111,   95,   79,   64,   48,   32,   16,
+		   0,  -16,  -32,  -48,  -64,  -79,  -95, -111,
+		-127, -111,  -95,  -79,  -64,  -48,  -32,  -16
+	},
+	{
+		 127,  127,  127,  127,  127,  127,  127,  127,
+		 127,  127,  127,  127,  127,  127,  127,  127,
+		-127, -127, -127, -127, -127, -127, -127, -127,
+		-127, -127, -127, -127, -127, -127, -127, -127
+	}
+};
+#endif
+
+#if BUZZER_USE_ENVELOPE
+static const uint8_t _envFall[BUZZER_ENV_LEN] = {
+	255, 224, 198, 174, 153, 134, 118, 104,
+	 91,  80,  70,  61,  53,  46,  40,  35,
+	 30,  26,  23,  19,  17,  14,  12,  10,
+	  8,   7,   5,   4,   3,   2,   1,   1
+};
+#endif
 
 // aux functions
 
+static inline void __buzzer_trace_start(buzzer_t *buzzer, uint16_t freq){
+#if BUZZER_USE_TRACE
+	if (buzzer->active){
+		BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_PREEMPT, buzzer->play_param.freq);
+	}
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_START, freq);
+#else
+	(void)buzzer;
+	(void)freq;
+#endif
+}
+
+// idle and wake, on the first instance that starts and the last that ends
+
+void __buzzer_acquire(void){
+	uint32_t count;
+
+	BUZZER_CRITICAL_ENTER();
+	count = _activeCount++;
+	BUZZER_CRITICAL_EXIT();
+	if (count == 0){
+		buzzer_wake_callback();
+	}
+}
+
+void __buzzer_activate(buzzer_t *buzzer){
+	if (buzzer->active == BUZZER_IS_NOT_ACTIVE){
+		buzzer->active = BUZZER_IS_ACTIVE;
+		__buzzer_acquire();
+	}
+}
+
+void __buzzer_release(void){
+	uint32_t count;
+
+	BUZZER_CRITICAL_ENTER();
+	count = --_activeCount;
+	BUZZER_CRITICAL_EXIT();
+	if (count == 0){
+		buzzer_idle_callback();
+	}
+}
+
+void __buzzer_deactivate(buzzer_t *buzzer){
+	buzzer->state = BUZZER_STATE_IDLE;
+	if (buzzer->active == BUZZER_IS_ACTIVE){
+		buzzer->active = BUZZER_IS_NOT_ACTIVE;
+		__buzzer_release();
+	}
+}
+
+// outputs, the driver is called only when the value changes
+
+void __buzzer_gpio_write(buzzer_t *buzzer, uint8_t val){
+	if ((buzzer->out.valid & _OUT_GPIO) && buzzer->out.gpio == val){
+		buzzer->out.elided++;
+		return;
+	}
+	buzzer->out.gpio = val;
+	buzzer->out.valid |= _OUT_GPIO;
+	_GPIO_OUT(buzzer, val);
+}
+
+void __buzzer_pwm_write(buzzer_t *buzzer, uint32_t freq){
+	if ((buzzer->out.valid & _OUT_FREQ) && buzzer->out.freq == freq){
+		buzzer->out.elided++;
+		return;
+	}
+	buzzer->out.freq = freq;
+	buzzer->out.valid |= _OUT_FREQ;
+	_PWM_OUT(buzzer, freq);
+}
+
+void __buzzer_duty_write(buzzer_t *buzzer, uint32_t duty){
+	if ((buzzer->out.valid & _OUT_DUTY) && buzzer->out.duty == duty){
+		buzzer->out.elided++;
+		return;
+	}
+	buzzer->out.duty = duty;
+	buzzer->out.valid |= _OUT_DUTY;
+	_DUTY_OUT(buzzer, duty);
+}
+
 void __buzzer_stop_gpio(buzzer_t *buzzer){
-	if (buzzer->fnx.gpioOut != NULL)
-		buzzer->fnx.gpioOut(_LOW);
+#if BUZZER_USE_SOFTPWM
+	if (_SOFTPWM_ON(buzzer)){
+		buzzer->softpwm.pattern = 0;
+		return;
+	}
+#endif
+	if (_HAS_GPIO(buzzer))
+		__buzzer_gpio_write(buzzer, _LOW);
 }
 
 void __buzzer_stop_pwm(buzzer_t *buzzer){
-	if (buzzer->fnx.pwmOut != NULL)
-		buzzer->fnx.pwmOut(0);
+#if BUZZER_USE_ENVELOPE
+	buzzer->env.phase = _ENV_OFF;
+#endif
+#if BUZZER_USE_LFO
+	buzzer->lfo.sounding = 0;
+#endif
+#if BUZZER_USE_GLIDE
+	buzzer->glide.steps = 0;
+#endif
+	if (_HAS_PWM(buzzer))
+		__buzzer_pwm_write(buzzer, 0);
+}
+
+// a new play, or the end of one, stops the effects of the previous one
+void __buzzer_effects_off(buzzer_t *buzzer){
+#if BUZZER_USE_CHORDS
+	buzzer->play_param.arpN = 0;
+#endif
+#if BUZZER_USE_GLIDE
+	buzzer->glide.steps = 0;
+#endif
+#if BUZZER_USE_SFX
+	buzzer->sfx.p = NULL;
+#endif
+	(void)buzzer;
+}
+
+void __buzzer_note_off(buzzer_t *buzzer){
+	if (_IS_ACTIVE(buzzer)){
+		__buzzer_stop_gpio(buzzer);
+	}
+	else{
+		__buzzer_stop_pwm(buzzer);
+	}
 }
 
 void __buzzer_turn_on_gpio(buzzer_t *buzzer){
-	if (buzzer->fnx.gpioOut != NULL)
-		buzzer->fnx.gpioOut(_HIGH);
+#if BUZZER_USE_SOFTPWM
+	if (_SOFTPWM_ON(buzzer)){
+		buzzer->softpwm.pattern = _softpwmPattern[buzzer->softpwm.level];
+		return;
+	}
+#endif
+	if (_HAS_GPIO(buzzer))
+		__buzzer_gpio_write(buzzer, _HIGH);
+}
+
+void __buzzer_note_on_gpio(buzzer_t *buzzer, uint32_t freq){
+#if BUZZER_USE_SOFTPWM
+	if (_SOFTPWM_ON(buzzer)){
+		// square wave gating on freq, 0 keeps the native tone
+		buzzer->softpwm.phase = 0;
+		buzzer->softpwm.inc = ((uint64_t)freq << 32) / buzzer->softpwm.hz;
+	}
+#else
+	(void)freq;
+#endif
+	__buzzer_turn_on_gpio(buzzer);
 }
 
 void __buzzer_turn_on_pwm(buzzer_t *buzzer, uint32_t freq){
-	if (buzzer->fnx.pwmOut != NULL)
-		buzzer->fnx.pwmOut(freq);
+	if (_HAS_PWM(buzzer))
+		__buzzer_pwm_write(buzzer, freq);
+}
+
+#if BUZZER_USE_ENVELOPE
+// envelope
+
+uint32_t __buzzer_env_inc(buzzer_t *buzzer, uint16_t phaseMs){
+	uint32_t stepMs = buzzer->env.div * _TICK_MS(buzzer);
+
+	if (phaseMs <= stepMs){
+		return (uint32_t)BUZZER_ENV_LEN << 16;
+	}
+	return (((uint32_t)BUZZER_ENV_LEN << 16) / phaseMs) * stepMs;
+}
+#endif
+
+// duty = envelope level * tremolo * velocity * dutyMax
+void __buzzer_duty_out(buzzer_t *buzzer){
+	uint32_t level = (buzzer->env.level * _TREM_GAIN(buzzer)) >> 8;
+
+	__buzzer_duty_write(buzzer, (level * buzzer->env.gain + 0x7FFF) >> 16);
+}
+
+#if BUZZER_USE_ENVELOPE
+void __buzzer_env_level(buzzer_t *buzzer, uint8_t level){
+	if (level != buzzer->env.level){
+		buzzer->env.level = level;
+		__buzzer_duty_out(buzzer);
+	}
+}
+
+void __buzzer_env_note_on(buzzer_t *buzzer){
+	buzzer->env.phase = _ENV_ATTACK;
+	buzzer->env.acc = 0;
+	buzzer->env.inc = __buzzer_env_inc(buzzer, buzzer->envelope->attackMs);
+	buzzer->env.cnt = buzzer->env.div;
+	buzzer->env.level = 0xFF;
+	__buzzer_env_level(buzzer, _envRise[0]);
+}
+
+void __buzzer_env_update(buzzer_t *buzzer){
+	const buzzer_envelope_t *envelope = buzzer->envelope;
+	uint32_t idx;
+	uint8_t level = buzzer->env.level;
+
+	buzzer->env.cnt = buzzer->env.div;
+	if (buzzer->env.phase < _ENV_RELEASE && buzzer->play_param.len > 0 &&
+			buzzer->counting + envelope->releaseMs >= (uint_fast16_t)buzzer->play_param.time){
+		buzzer->env.phase = _ENV_RELEASE;
+		buzzer->env.relLevel = level;
+		buzzer->env.acc = 0;
+		buzzer->env.inc = __buzzer_env_inc(buzzer, envelope->releaseMs);
+	}
+	buzzer->env.acc += buzzer->env.inc;
+	idx = buzzer->env.acc >> 16;
+	switch (buzzer->env.phase){
+	case _ENV_ATTACK:
+		if (idx < BUZZER_ENV_LEN){
+			level = _envRise[idx];
+			break;
+		}
+		buzzer->env.phase = _ENV_DECAY;
+		buzzer->env.acc = 0;
+		buzzer->env.inc = __buzzer_env_inc(buzzer, envelope->decayMs);
+		level = 0xFF;
+		break;
+	case _ENV_DECAY:
+		if (idx < BUZZER_ENV_LEN){
+			level = envelope->sustain + (((0xFF - envelope->sustain) * _envFall[idx]) >> 8);
+			break;
+		}
+		buzzer->env.phase = _ENV_SUSTAIN;
+		level = envelope->sustain;
+		break;
+	case _ENV_RELEASE:
+		if (idx < BUZZER_ENV_LEN){
+			level = (buzzer->env.relLevel * _envFall[idx]) >> 8;
+			break;
+		}
+		buzzer->env.phase = _ENV_OFF;
+		level = 0;
+		break;
+	default:
+		break;
+	}
+	__buzzer_env_level(buzzer, level);
+}
+#endif
+
+#if BUZZER_USE_GLIDE
+// glide
+
+uint32_t __buzzer_log2_q16(uint32_t freq){
+	uint32_t n = 31 - __builtin_clz(freq);
+	uint32_t mant = freq << (31 - n);
+	uint32_t idx = (mant >> 26) & 0x1F;
+	uint32_t frac = (mant >> 10) & 0xFFFF;
+
+	return (n << 16) + _log2Tab[idx] +
+			(((_log2Tab[idx + 1] - _log2Tab[idx]) * frac) >> 16);
+}
+
+uint32_t __buzzer_exp2_q16(uint32_t pos){
+	uint32_t idx = (pos >> 11) & 0x1F;
+	uint32_t rem = pos & 0x7FF;
+	uint32_t m = _exp2Tab[idx] + (((_exp2Tab[idx + 1] - _exp2Tab[idx]) * rem) >> 11);
+
+	return (m << (pos >> 16)) >> 16;
+}
+
+/**
+ * prepares the slide from the current freq to the note, the increment
+ * is computed once, so each step is only an add
+ */
+uint32_t __buzzer_glide_start(buzzer_t *buzzer, uint16_t note){
+	uint32_t to = note & BUZZER_FREQ_MASK;
+	uint32_t from = buzzer->play_param.freq;
+	uint32_t ms, stepMs;
+	uint_fast16_t steps;
+
+	buzzer->glide.steps = 0;
+	if ((note & BUZZER_GLIDE_FLAG) == 0 || from == 0 || to == 0 || from == to){
+		return to;
+	}
+	ms = buzzer->glideMs ? buzzer->glideMs : (uint32_t)buzzer->play_param.time;
+	buzzer->glide.div = 1;
+	if (buzzer->glideStepMs > _TICK_MS(buzzer)){
+		buzzer->glide.div = buzzer->glideStepMs / _TICK_MS(buzzer);
+	}
+	stepMs = buzzer->glide.div * _TICK_MS(buzzer);
+	steps = ms / stepMs;
+	if (steps < 2){
+		return to;
+	}
+	buzzer->glide.exp = (note & BUZZER_GLIDE_EXP_FLAG) != 0;
+	if (buzzer->glide.exp){
+		buzzer->glide.pos = __buzzer_log2_q16(from);
+		buzzer->glide.inc = ((int32_t)__buzzer_log2_q16(to) - (int32_t)buzzer->glide.pos) / (int32_t)steps;
+	}
+	else{
+		buzzer->glide.pos = from << 16;
+		buzzer->glide.inc = ((int32_t)(to << 16) - (int32_t)buzzer->glide.pos) / (int32_t)steps;
+	}
+	buzzer->glide.to = to;
+	buzzer->glide.steps = steps;
+	buzzer->glide.cnt = buzzer->glide.div;
+
+	return from;
+}
+
+void __buzzer_glide_step(buzzer_t *buzzer){
+	uint32_t freq;
+
+	buzzer->glide.cnt = buzzer->glide.div;
+	buzzer->glide.pos += buzzer->glide.inc;
+	if (--buzzer->glide.steps == 0){
+		freq = buzzer->glide.to;
+	}
+	else if (buzzer->glide.exp){
+		freq = __buzzer_exp2_q16(buzzer->glide.pos);
+	}
+	else{
+		freq = buzzer->glide.pos >> 16;
+	}
+	buzzer->play_param.freq = freq;
+	__buzzer_turn_on_pwm(buzzer, freq);
+}
+#endif
+
+#if BUZZER_USE_LFO
+// LFOs
+
+void __buzzer_lfo_update(buzzer_t *buzzer){
+	int32_t w;
+	uint32_t freq;
+
+	buzzer->lfo.cnt = buzzer->lfo.div;
+	if (!buzzer->lfo.sounding){
+		return;
+	}
+	if (buzzer->lfo.vibDepth != 0){
+		buzzer->lfo.vibPhase += buzzer->lfo.vibInc;
+		w = _lfoWave[buzzer->lfo.vibWave][buzzer->lfo.vibPhase >> 27];
+		freq = buzzer->play_param.freq;
+#if BUZZER_USE_CHORDS
+		if (buzzer->play_param.arpN > 1){
+			freq = buzzer->play_param.pArp[buzzer->play_param.arpI];
+		}
+#endif
+		__buzzer_turn_on_pwm(buzzer, freq + (((int32_t)freq * buzzer->lfo.vibDepth * w) >> 16));
+	}
+	if (buzzer->lfo.tremDepth != 0){
+		buzzer->lfo.tremPhase += buzzer->lfo.tremInc;
+		w = _lfoWave[buzzer->lfo.tremWave][buzzer->lfo.tremPhase >> 27];
+		buzzer->lfo.tremGain = 0xFF - ((buzzer->lfo.tremDepth * (127 - w)) >> 8);
+		__buzzer_duty_out(buzzer);
+	}
+}
+
+uint32_t __buzzer_lfo_inc(buzzer_t *buzzer, uint16_t rate){
+	// rate in 0.1Hz, one update every div * interruptMs
+	return ((uint64_t)rate << 32) * buzzer->lfo.div * _TICK_MS(buzzer) / 10000;
+}
+
+uint8_t __buzzer_lfo_setup(buzzer_t *buzzer){
+	if (buzzer == NULL || _TICK_MS(buzzer) == 0 ||
+			!_IS_PASSIVE(buzzer)){
+		return 0;
+	}
+	buzzer->lfo.div = 1;
+	if (buzzer->lfoMs > _TICK_MS(buzzer)){
+		buzzer->lfo.div = buzzer->lfoMs / _TICK_MS(buzzer);
+	}
+	buzzer->lfo.cnt = buzzer->lfo.div;
+
+	return 1;
+}
+#endif
+
+void __buzzer_note_on_pwm(buzzer_t *buzzer, uint32_t freq){
+	__buzzer_turn_on_pwm(buzzer, freq);
+#if BUZZER_USE_LFO
+	buzzer->lfo.sounding = (freq != 0);
+#endif
+	buzzer->env.level = 0xFF;
+#if BUZZER_USE_ENVELOPE
+	buzzer->env.gain = buzzer->play_param.velocity *
+			((buzzer->envelope != NULL) ? buzzer->envelope->dutyMax : _DUTY_DEFAULT);
+	if (buzzer->envelope != NULL){
+		if (freq != 0){
+			__buzzer_env_note_on(buzzer);
+		}
+		else{
+			buzzer->env.phase = _ENV_OFF;
+		}
+		return;
+	}
+#else
+	buzzer->env.gain = buzzer->play_param.velocity * _DUTY_DEFAULT;
+#endif
+	// without an envelope the velocity sets the duty of the whole note,
+	// 255 is exactly the default duty
+	if (_HAS_DUTY(buzzer) && freq != 0){
+		__buzzer_duty_write(buzzer, (buzzer->play_param.velocity * _DUTY_DEFAULT + 127) / 255);
+	}
+}
+
+// end of a play
+
+void __buzzer_finish(buzzer_t *buzzer){
+	if (_IS_ACTIVE(buzzer)){
+		__buzzer_stop_gpio(buzzer);
+	}
+	else{
+		__buzzer_stop_pwm(buzzer);
+	}
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_STOP, 0);
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_CALLBACK, 0);
+	__buzzer_effects_off(buzzer);
+	// cleared before the callback, that can start another play. The
+	// instance is only released after it, so a new play doesn't
+	// trigger an idle and a wake
+	buzzer->active = BUZZER_IS_NOT_ACTIVE;
+	buzzer->state = BUZZER_STATE_IDLE;
+	buzzer_end_callback(buzzer);
+	__buzzer_release();
+}
+
+#if BUZZER_USE_SFX
+// sound effects
+
+void __buzzer_sfx_phase(buzzer_t *buzzer, uint8_t phase){
+	const buzzer_sfx_t *sfx = buzzer->sfx.p;
+	uint32_t units = (phase == _SFX_ATTACK) ? sfx->attack :
+			(phase == _SFX_SUSTAIN) ? sfx->sustain : sfx->decay;
+	uint32_t steps = (units * _SFX_MS_UNIT) / (buzzer->sfx.div * _TICK_MS(buzzer));
+
+	buzzer->sfx.phase = phase;
+	buzzer->sfx.steps = (steps > 0) ? steps : 1;
+	switch (phase){
+	case _SFX_ATTACK:
+		buzzer->sfx.vol = 0;
+		buzzer->sfx.volInc = (0xFFUL << 16) / buzzer->sfx.steps;
+		break;
+	case _SFX_SUSTAIN:
+		buzzer->sfx.vol = (0xFFUL + (0xFFUL * sfx->punch) / 100) << 16;
+		buzzer->sfx.volInc = (buzzer->sfx.vol - (0xFFUL << 16)) / buzzer->sfx.steps;
+		break;
+	default:
+		buzzer->sfx.vol = 0xFFUL << 16;
+		buzzer->sfx.volInc = buzzer->sfx.vol / buzzer->sfx.steps;
+		break;
+	}
+}
+
+void __buzzer_sfx_restart(buzzer_t *buzzer){
+	buzzer->sfx.freq = (uint32_t)buzzer->sfx.p->baseFreq << 4;
+	buzzer->sfx.slide = buzzer->sfx.p->slide;
+	buzzer->sfx.arpCnt = 0;
+	buzzer->sfx.repCnt = 0;
 }
 
+void __buzzer_sfx_out(buzzer_t *buzzer){
+	uint32_t vol = buzzer->sfx.vol >> 16;
+
+	buzzer->play_param.freq = buzzer->sfx.freq >> 4;
+	__buzzer_turn_on_pwm(buzzer, buzzer->play_param.freq);
+	if (_HAS_DUTY(buzzer)){
+		buzzer->env.gain = 0xFF * (buzzer->sfx.duty >> 4);
+		buzzer->env.level = (vol > 0xFF) ? 0xFF : vol;
+		__buzzer_duty_out(buzzer);
+	}
+}
+
+void __buzzer_sfx_step(buzzer_t *buzzer){
+	const buzzer_sfx_t *sfx = buzzer->sfx.p;
+
+	buzzer->sfx.cnt = buzzer->sfx.div;
+	if (sfx->repeatSteps != 0 && ++buzzer->sfx.repCnt >= sfx->repeatSteps){
+		__buzzer_sfx_restart(buzzer);
+	}
+	buzzer->sfx.slide += sfx->deltaSlide;
+	buzzer->sfx.freq += buzzer->sfx.slide;
+	if ((int32_t)buzzer->sfx.freq <= (int32_t)(sfx->minFreq * 10 * 16)){
+		__buzzer_finish(buzzer);
+		return;
+	}
+	if (buzzer->sfx.freq > ((uint32_t)BUZZER_FREQ_MASK << 4)){
+		buzzer->sfx.freq = (uint32_t)BUZZER_FREQ_MASK << 4;
+	}
+	if (sfx->arpMul != 0 && ++buzzer->sfx.arpCnt == sfx->arpSteps){
+		buzzer->sfx.freq = (buzzer->sfx.freq * sfx->arpMul) >> 4;
+	}
+	buzzer->sfx.duty += sfx->dutySweep;
+	if (buzzer->sfx.duty < 16){
+		buzzer->sfx.duty = 16;
+	}
+	else if (buzzer->sfx.duty > (_DUTY_DEFAULT << 4)){
+		buzzer->sfx.duty = _DUTY_DEFAULT << 4;
+	}
+	if (buzzer->sfx.phase == _SFX_ATTACK){
+		buzzer->sfx.vol += buzzer->sfx.volInc;
+	}
+	else{
+		buzzer->sfx.vol -= buzzer->sfx.volInc;
+	}
+	if (--buzzer->sfx.steps == 0){
+		if (buzzer->sfx.phase == _SFX_DECAY){
+			__buzzer_finish(buzzer);
+			return;
+		}
+		__buzzer_sfx_phase(buzzer, buzzer->sfx.phase + 1);
+	}
+	__buzzer_sfx_out(buzzer);
+}
+#endif
+
+#if BUZZER_USE_CHORDS
+// chords
+
+void __buzzer_chord_load(buzzer_t *buzzer, uint_fast16_t i){
+	uint16_t *pArp = buzzer->play_param.pChord[i].freq;
+	uint8_t n = 0;
+
+	while (n < BUZZER_CHORD_MAX && pArp[n] != 0){
+		n++;
+	}
+	buzzer->play_param.pArp = pArp;
+	buzzer->play_param.arpN = n;
+	buzzer->play_param.arpI = 0;
+	buzzer->play_param.arpCnt = buzzer->play_param.arpTicks;
+	buzzer->play_param.freq = pArp[0];
+	__buzzer_note_on_pwm(buzzer, pArp[0]);
+}
+
+void __buzzer_arpeggio_step(buzzer_t *buzzer){
+	buzzer->play_param.arpI++;
+	if (buzzer->play_param.arpI >= buzzer->play_param.arpN){
+		buzzer->play_param.arpI = 0;
+	}
+	buzzer->play_param.arpCnt = buzzer->play_param.arpTicks;
+	__buzzer_turn_on_pwm(buzzer, buzzer->play_param.pArp[buzzer->play_param.arpI]);
+}
+#endif
+
 void __buzzer_start_gpio(buzzer_t *buzzer){
-    __buzzer_turn_on_gpio(buzzer);
+    __buzzer_note_on_gpio(buzzer, buzzer->play_param.freq);
 }
 
 void __buzzer_start_pwm(buzzer_t *buzzer){
-    __buzzer_turn_on_pwm(buzzer, buzzer->play_param.freq);
+    __buzzer_note_on_pwm(buzzer, buzzer->play_param.freq);
 }
 
 
 void __buzzer_start_array_gpio(buzzer_t *buzzer){
-    __buzzer_turn_on_gpio(buzzer);
     buzzer->play_param.time = buzzer->play_param.pTimes[0];
-
+    if (buzzer->play_param.pFreq != NULL && _SOFTPWM_ON(buzzer)){
+        buzzer->play_param.freq = buzzer->play_param.pFreq[0] & BUZZER_FREQ_MASK;
+        if (buzzer->play_param.freq == 0){
+            __buzzer_stop_gpio(buzzer);
+            return;
+        }
+    }
+    __buzzer_note_on_gpio(buzzer, buzzer->play_param.freq);
 }
 
 void __buzzer_start_array_pwm(buzzer_t *buzzer){
-    __buzzer_turn_on_pwm(buzzer, buzzer->play_param.pFreq[0]);
     buzzer->play_param.time = buzzer->play_param.pTimes[0];
+    buzzer->play_param.freq = buzzer->play_param.pFreq[0] & BUZZER_FREQ_MASK;
+    __buzzer_note_on_pwm(buzzer, buzzer->play_param.freq);
 }
 
+#if BUZZER_USE_ARTIC
+// articulation, the note i is cut after its % of the period, on an edge
+// of the same event, and the rest keeps the total period of the note
+
+void __buzzer_artic_load(buzzer_t *buzzer, uint_fast16_t i){
+	uint32_t artic = buzzer->play_param.artic;
+	int_fast32_t sound;
+
+	buzzer->play_param.cut = 0;
+	if (buzzer->play_param.pArtic != NULL && buzzer->play_param.pArtic[i] != 0){
+		artic = buzzer->play_param.pArtic[i];
+	}
+	if (artic == 0 || artic >= 100 || _TICK_MS(buzzer) == 0 ||
+			(buzzer->play_param.pFreq != NULL &&
+			(buzzer->play_param.pFreq[i] & BUZZER_FREQ_MASK) == 0)){
+		return;
+	}
+	// the edges are on the first tick after the time, as the note edges
+	sound = buzzer->play_param.time * artic / 100;
+	sound = (sound / _TICK_MS(buzzer) + 1) * _TICK_MS(buzzer);
+	if (sound > buzzer->play_param.time){
+		return;
+	}
+	buzzer->play_param.rest = buzzer->play_param.time - sound;
+	buzzer->play_param.time = sound - _TICK_MS(buzzer);
+	buzzer->play_param.cut = 1;
+}
+
+void __buzzer_artic_cut(buzzer_t *buzzer){
+	buzzer->play_param.cut = 0;
+	buzzer->play_param.time = buzzer->play_param.rest;
+	buzzer->play_param.freq = 0;
+	__buzzer_note_off(buzzer);
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, 0);
+}
+#endif
+
+// next note of an array, from the pFreq value
+void __buzzer_array_note(buzzer_t *buzzer, uint16_t note){
+	if (_IS_ACTIVE(buzzer)){
+		buzzer->play_param.freq = note & BUZZER_FREQ_MASK;
+		if (_SOFTPWM_ON(buzzer) && buzzer->play_param.freq == 0){
+			__buzzer_stop_gpio(buzzer);
+		}
+		else{
+			__buzzer_note_on_gpio(buzzer, buzzer->play_param.freq);
+		}
+	}
+	else{
+#if BUZZER_USE_GLIDE
+		buzzer->play_param.freq = __buzzer_glide_start(buzzer, note);
+#else
+		buzzer->play_param.freq = note & BUZZER_FREQ_MASK;
+#endif
+		__buzzer_note_on_pwm(buzzer, buzzer->play_param.freq);
+	}
+}
+
+#if BUZZER_USE_PACKED
+// packed melodies, decoded one note at a time
+
+void __buzzer_packed_duration(buzzer_t *buzzer, uint8_t dur){
+	uint32_t div = dur & BUZZER_PACKED_DIV_MASK;
+	uint32_t ms = buzzer->play_param.packedWhole;
+
+	if (div == 0){
+		div = 1;
+	}
+	if (dur & BUZZER_PACKED_DOT_FLAG){
+		ms += ms / 2;
+	}
+	buzzer->play_param.packedMs = ms / div;
+}
+
+uint16_t __buzzer_packed_pitch(uint8_t note){
+	note &= BUZZER_PACKED_PITCH_MASK;
+	if (note >= BUZZER_PACKED_PITCHES){
+		return 0;
+	}
+	return _packedPitch[note];
+}
+
+void __buzzer_packed_note(buzzer_t *buzzer){
+	uint8_t note = *buzzer->play_param.pPacked++;
+
+	if (note & BUZZER_PACKED_DUR_FLAG){
+		__buzzer_packed_duration(buzzer, *buzzer->play_param.pPacked++);
+	}
+	buzzer->play_param.time = buzzer->play_param.packedMs;
+	__buzzer_array_note(buzzer, __buzzer_packed_pitch(note));
+}
+#endif
+
+#if BUZZER_USE_PATTERN
+// patterns, the bit 0 of the mask is the current slot
+
+void __buzzer_pattern_slot(buzzer_t *buzzer){
+	uint8_t on = buzzer->play_param.patMask & 1;
+
+	// equal bits are a single note, without writes
+	if (on == buzzer->play_param.patOn){
+		return;
+	}
+	buzzer->play_param.patOn = on;
+	if (!on){
+		__buzzer_note_off(buzzer);
+	}
+	else if (_IS_ACTIVE(buzzer)){
+		__buzzer_note_on_gpio(buzzer, buzzer->play_param.freq);
+	}
+	else{
+		__buzzer_note_on_pwm(buzzer, buzzer->play_param.freq);
+	}
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, on ? buzzer->play_param.freq : 0);
+}
+#endif
+
+#if BUZZER_USE_MORSE
+// Morse, the code of a character is loaded in the gap before it
+
+uint8_t __buzzer_morse_code(char c){
+	if (c >= 'a' && c <= 'z'){
+		c -= 'a' - 'A';
+	}
+	if (c < ' ' || c > '_'){
+		return 0;
+	}
+	return _morseCode[c - ' '];
+}
+
+// the code of the next character after *ppText, 0 at its end, and moves
+// *ppText past it. pSpace is set when spaces were skipped
+uint8_t __buzzer_morse_scan(const char **ppText, uint8_t *pSpace){
+	const char *p = *ppText;
+	uint8_t code = 0;
+
+	*pSpace = 0;
+	while (code == 0 && *p != '\0'){
+		if (*p == ' '){
+			*pSpace = 1;
+		}
+		else{
+			code = __buzzer_morse_code(*p);
+		}
+		p++;
+	}
+	*ppText = p;
+
+	return code;
+}
+
+// the code of the next character of the text, 0 at its end. The gap
+// before it is a word gap when spaces were skipped
+uint8_t __buzzer_morse_load(buzzer_t *buzzer, int_fast32_t *pGap){
+	uint8_t space;
+	uint8_t code = __buzzer_morse_scan(&buzzer->play_param.pText, &space);
+
+	*pGap = space ? buzzer->play_param.morseWord : buzzer->play_param.morseChar;
+
+	return code;
+}
+
+// starts the next element of the code, a dit or a dah
+void __buzzer_morse_element(buzzer_t *buzzer){
+	uint8_t code = buzzer->play_param.morseCode;
+
+	buzzer->play_param.i = 0;
+	buzzer->play_param.time = (code & 1) ? buzzer->play_param.morseDah : buzzer->play_param.morseDit;
+	buzzer->play_param.morseCode = code >> 1;
+	if (_IS_ACTIVE(buzzer)){
+		__buzzer_note_on_gpio(buzzer, buzzer->play_param.freq);
+	}
+	else{
+		__buzzer_note_on_pwm(buzzer, buzzer->play_param.freq);
+	}
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, buzzer->play_param.freq);
+}
+#endif
+
+// states, the handler of the state is called by buzzer_interrupt() when
+// the time of the current note is over
+
+void __buzzer_enter(buzzer_t *buzzer, uint8_t state){
+	buzzer->state = state;
+	buzzer->counting = 0;
+	// a new play discards the paused one
+	buzzer->paused.state = BUZZER_STATE_IDLE;
+}
+
+// time of a note that lasts ms, the edges are on the first tick after the
+// time, so the note ends on its last tick
+int_fast32_t __buzzer_ms_time(buzzer_t *buzzer, uint32_t ms){
+	(void)buzzer;
+	if (ms > _TICK_MS(buzzer)){
+		return ms - _TICK_MS(buzzer);
+	}
+	return 0;
+}
+
+// idle, hold and sfx have no notes
+void __buzzer_state_none(buzzer_t *buzzer){
+	(void)buzzer;
+}
+
+// sounds for time, then is silent for time, and ends
+void __buzzer_state_timed(buzzer_t *buzzer){
+	if (++buzzer->play_param.i >= 2){
+		__buzzer_finish(buzzer);
+		return;
+	}
+	__buzzer_note_off(buzzer);
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, 0);
+}
+
+void __buzzer_state_blink(buzzer_t *buzzer){
+	buzzer->play_param.i ^= 1;
+	if (buzzer->play_param.i){
+		__buzzer_note_off(buzzer);
+	}
+	else if (_IS_ACTIVE(buzzer)){
+		__buzzer_turn_on_gpio(buzzer);
+	}
+	else{
+		__buzzer_note_on_pwm(buzzer, buzzer->play_param.freq);
+	}
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE,
+			buzzer->play_param.i ? 0 : buzzer->play_param.freq);
+}
+
+// starts the note i of an array or melody
+void __buzzer_sequence_note(buzzer_t *buzzer, uint_fast16_t i){
+	buzzer->play_param.i = i;
+	buzzer->play_param.time = buzzer->play_param.pTimes[i];
+	if (buzzer->play_param.pFreq != NULL){
+		if (buzzer->play_param.pVelocity != NULL){
+			buzzer->play_param.velocity = buzzer->play_param.pVelocity[i];
+		}
+		__buzzer_array_note(buzzer, buzzer->play_param.pFreq[i]);
+	}
+	else if (_IS_ACTIVE(buzzer)){
+		// no pitches, each note turns on again after an articulation cut
+		__buzzer_note_on_gpio(buzzer, buzzer->play_param.freq);
+	}
+#if BUZZER_USE_ARTIC
+	__buzzer_artic_load(buzzer, i);
+#endif
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, buzzer->play_param.freq);
+}
+
+void __buzzer_state_sequence(buzzer_t *buzzer){
+	uint_fast16_t i;
+
+#if BUZZER_USE_ARTIC
+	if (buzzer->play_param.cut){
+		__buzzer_artic_cut(buzzer);
+		return;
+	}
+#endif
+	i = buzzer->play_param.i + 1;
+	if (i >= buzzer->play_param.len){
+		__buzzer_finish(buzzer);
+		return;
+	}
+	__buzzer_sequence_note(buzzer, i);
+}
+
+#if BUZZER_USE_CHORDS
+void __buzzer_state_chords(buzzer_t *buzzer){
+	uint_fast16_t i = ++buzzer->play_param.i;
+
+	if (i >= buzzer->play_param.len){
+		__buzzer_finish(buzzer);
+		return;
+	}
+	buzzer->play_param.time = buzzer->play_param.pTimes[i];
+	__buzzer_chord_load(buzzer, i);
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, buzzer->play_param.freq);
+}
+#endif
+
+#if BUZZER_USE_PACKED
+void __buzzer_state_packed(buzzer_t *buzzer){
+	if (++buzzer->play_param.i >= buzzer->play_param.len){
+		__buzzer_finish(buzzer);
+		return;
+	}
+	__buzzer_packed_note(buzzer);
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, buzzer->play_param.freq);
+}
+#endif
+
+#if BUZZER_USE_PATTERN
+void __buzzer_state_pattern(buzzer_t *buzzer){
+	buzzer->play_param.patMask >>= 1;
+	if (--buzzer->play_param.patLeft == 0){
+		if (buzzer->play_param.patRepeat == 0){
+			__buzzer_finish(buzzer);
+			return;
+		}
+		if (buzzer->play_param.patRepeat != BUZZER_PATTERN_FOREVER){
+			buzzer->play_param.patRepeat--;
+		}
+		buzzer->play_param.patMask = buzzer->play_param.patReload;
+		buzzer->play_param.patLeft = buzzer->play_param.patBits;
+	}
+	__buzzer_pattern_slot(buzzer);
+}
+#endif
+
+#if BUZZER_USE_BURST
+// i is 0 while a pulse sounds, the silences after the pulses are the off
+// or the pause times
+void __buzzer_state_burst(buzzer_t *buzzer){
+	if (buzzer->play_param.i != 0){
+		buzzer->play_param.i = 0;
+		buzzer->play_param.time = buzzer->play_param.burstOn;
+		if (_IS_ACTIVE(buzzer)){
+			__buzzer_note_on_gpio(buzzer, buzzer->play_param.freq);
+		}
+		else{
+			__buzzer_note_on_pwm(buzzer, buzzer->play_param.freq);
+		}
+		BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, buzzer->play_param.freq);
+		return;
+	}
+	if (--buzzer->play_param.burstLeft != 0){
+		buzzer->play_param.time = buzzer->play_param.burstOff;
+	}
+	else{
+		if (buzzer->play_param.burstRepeat == 1){
+			__buzzer_finish(buzzer);
+			return;
+		}
+		if (buzzer->play_param.burstRepeat != BUZZER_BURST_FOREVER){
+			buzzer->play_param.burstRepeat--;
+		}
+		buzzer->play_param.burstLeft = buzzer->play_param.burstPulses;
+		buzzer->play_param.time = buzzer->play_param.burstPause;
+	}
+	buzzer->play_param.i = 1;
+	__buzzer_note_off(buzzer);
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, 0);
+}
+#endif
+
+#if BUZZER_USE_MORSE
+// i is 0 while an element sounds, and 1 in the gap after it
+void __buzzer_state_morse(buzzer_t *buzzer){
+	int_fast32_t gap = buzzer->play_param.morseDit;
+
+	if (buzzer->play_param.i != 0){
+		__buzzer_morse_element(buzzer);
+		return;
+	}
+	// only the end marker is left, the character is over
+	if (buzzer->play_param.morseCode == 1){
+		buzzer->play_param.morseCode = __buzzer_morse_load(buzzer, &gap);
+		if (buzzer->play_param.morseCode == 0){
+			__buzzer_finish(buzzer);
+			return;
+		}
+	}
+	buzzer->play_param.i = 1;
+	buzzer->play_param.time = gap;
+	__buzzer_note_off(buzzer);
+	BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, 0);
+}
+#endif
+
+#if BUZZER_USE_SEEK
+// position of the arrays and melodies, a note of time lasts up to the
+// first tick after it
+
+uint32_t __buzzer_note_ms(buzzer_t *buzzer, int_fast32_t time){
+	(void)buzzer;
+	return (time / _TICK_MS(buzzer) + 1) * _TICK_MS(buzzer);
+}
+
+uint32_t __buzzer_sequence_start_ms(buzzer_t *buzzer, uint_fast16_t i){
+	uint32_t ms = 0;
+	uint_fast16_t j;
+
+	if (buzzer->play_param.pIndex != NULL){
+		return buzzer->play_param.pIndex[i];
+	}
+	for (j = 0 ; j < i ; j++){
+		ms += __buzzer_note_ms(buzzer, buzzer->play_param.pTimes[j]);
+	}
+	return ms;
+}
+
+// the note playing at ms, and its start on *pStart. len when ms is beyond
+// the end
+uint_fast16_t __buzzer_sequence_find(buzzer_t *buzzer, uint32_t ms, uint32_t *pStart){
+	const uint32_t *pIndex = buzzer->play_param.pIndex;
+	uint_fast16_t lo = 0, hi = buzzer->play_param.len, mid;
+	uint32_t start = 0, d;
+
+	if (pIndex != NULL){
+		// the last note that starts up to ms
+		if (ms >= pIndex[hi]){
+			return hi;
+		}
+		while (hi - lo > 1){
+			mid = (lo + hi) / 2;
+			if (pIndex[mid] <= ms){
+				lo = mid;
+			}
+			else{
+				hi = mid;
+			}
+		}
+		*pStart = pIndex[lo];
+		return lo;
+	}
+	for ( ; lo < hi ; lo++){
+		d = __buzzer_note_ms(buzzer, buzzer->play_param.pTimes[lo]);
+		if (ms < start + d){
+			break;
+		}
+		start += d;
+	}
+	*pStart = start;
+	return lo;
+}
+
+// arrays and melodies, playing or paused
+uint8_t __buzzer_seekable(buzzer_t *buzzer){
+	return buzzer != NULL && _TICK_MS(buzzer) != 0 &&
+			(buzzer->state == BUZZER_STATE_SEQUENCE ||
+			buzzer->paused.state == BUZZER_STATE_SEQUENCE);
+}
+
+// starts the note i, offset ms after its start, rounded down to the tick
+void __buzzer_sequence_seek(buzzer_t *buzzer, uint_fast16_t i, uint32_t offset){
+	__buzzer_sequence_note(buzzer, i);
+#if BUZZER_USE_ARTIC
+	if (buzzer->play_param.cut &&
+			offset >= __buzzer_note_ms(buzzer, buzzer->play_param.time)){
+		offset -= __buzzer_note_ms(buzzer, buzzer->play_param.time);
+		__buzzer_artic_cut(buzzer);
+	}
+#endif
+	buzzer->counting = offset;
+}
+#endif
+
+static void (*const _stateHandlers[BUZZER_STATE_COUNT])(buzzer_t *buzzer) = {
+	[BUZZER_STATE_IDLE] = __buzzer_state_none,
+	[BUZZER_STATE_HOLD] = __buzzer_state_none,
+	[BUZZER_STATE_TIMED] = __buzzer_state_timed,
+	[BUZZER_STATE_BLINK] = __buzzer_state_blink,
+	[BUZZER_STATE_SEQUENCE] = __buzzer_state_sequence,
+#if BUZZER_USE_CHORDS
+	[BUZZER_STATE_CHORDS] = __buzzer_state_chords,
+#endif
+#if BUZZER_USE_PACKED
+	[BUZZER_STATE_PACKED] = __buzzer_state_packed,
+#endif
+#if BUZZER_USE_PATTERN
+	[BUZZER_STATE_PATTERN] = __buzzer_state_pattern,
+#endif
+#if BUZZER_USE_BURST
+	[BUZZER_STATE_BURST] = __buzzer_state_burst,
+#endif
+#if BUZZER_USE_MORSE
+	[BUZZER_STATE_MORSE] = __buzzer_state_morse,
+#endif
+	[BUZZER_STATE_SFX] = __buzzer_state_none,
+};
+
 
 
 
@@ -75,74 +1271,95 @@ void __attribute__((weak)) buzzer_end_callback(buzzer_t *buzzer){
 
 }
 
+void __attribute__((weak)) buzzer_wake_callback(void){
+
+}
+
+void __attribute__((weak)) buzzer_idle_callback(void){
+
+}
+
 // interrupts
 
 void buzzer_interrupt(buzzer_t *buzzer){
-	uint16_t i;
-
-//	if (buzzer->started == 0){
-//		return;
-//	}
-	buzzer->counting += buzzer->interruptMs;
-	if (buzzer->active &&
-			buzzer->play_param.len > 0 &&
-			buzzer->counting > buzzer->play_param.time){
-		i = buzzer->play_param.i;
+	uint8_t state = buzzer->state;
+
+	if (state == BUZZER_STATE_IDLE){
+		return;
+	}
+	buzzer->counting += _TICK_MS(buzzer);
+	if (buzzer->counting > buzzer->play_param.time){
 		buzzer->counting = 0;
-		buzzer->play_param.i++;
-		if (buzzer->play_param.i < buzzer->play_param.len){
-			if (buzzer->play_param.pTimes == NULL){
-				if (buzzer->play_param.loop == BUZZER_LOOP_ON){
-					buzzer->play_param.i %= 2;
-				}
-				if (buzzer->type == BUZZER_TYPE_ACTIVE){
-					if (buzzer->play_param.i){
-						__buzzer_stop_gpio(buzzer);
-					}
-					else{
-						__buzzer_turn_on_gpio(buzzer);
-					}
-				}
-				else{
-					if (buzzer->play_param.i){
-						__buzzer_stop_pwm(buzzer);
-					}
-					else{
-						__buzzer_turn_on_pwm(buzzer, buzzer->play_param.freq);
-					}
-				}
-			}
-			else{
-				buzzer->play_param.time = buzzer->play_param.pTimes[i];
-				buzzer->play_param.freq = buzzer->play_param.pFreq[i];
-				__buzzer_turn_on_pwm(buzzer, buzzer->play_param.freq);
-			}
-		}
-		else{
-			if (buzzer->type == BUZZER_TYPE_ACTIVE){
-				__buzzer_stop_gpio(buzzer);
-			}
-			else{
-				__buzzer_stop_pwm(buzzer);
-			}
-			buzzer_end_callback(buzzer);
-			buzzer->active = 0;
-		}
+		_stateHandlers[state](buzzer);
+	}
+#if BUZZER_USE_CHORDS
+	else if (buzzer->play_param.arpN > 1 && --buzzer->play_param.arpCnt == 0){
+		__buzzer_arpeggio_step(buzzer);
+	}
+#endif
+
+#if BUZZER_USE_SFX
+	if (buzzer->sfx.p != NULL && --buzzer->sfx.cnt == 0){
+		__buzzer_sfx_step(buzzer);
+	}
+#endif
+
+#if BUZZER_USE_GLIDE
+	if (buzzer->glide.steps != 0 && --buzzer->glide.cnt == 0){
+		__buzzer_glide_step(buzzer);
 	}
+#endif
+
+#if BUZZER_USE_ENVELOPE
+	if (buzzer->env.phase != _ENV_OFF && --buzzer->env.cnt == 0){
+		__buzzer_env_update(buzzer);
+	}
+#endif
+
+#if BUZZER_USE_LFO
+	if ((buzzer->lfo.vibDepth | buzzer->lfo.tremDepth) != 0 && --buzzer->lfo.cnt == 0){
+		__buzzer_lfo_update(buzzer);
+	}
+#endif
 }
 
 buzzer_err_e buzzer_init(buzzer_t *buzzer){
     if (buzzer != NULL){
-    	// nothing to do here yet
-    	if (buzzer->fnx.gpioOut){
+#if BUZZER_USE_TRACE
+    	buzzer->traceId = _traceIds++;
+#endif
+    	// a play that is running leaves the active set
+    	if (buzzer->active == BUZZER_IS_ACTIVE){
+    		__buzzer_release();
+    	}
+    	buzzer->active = BUZZER_IS_NOT_ACTIVE;
+    	__buzzer_effects_off(buzzer);
+    	buzzer->state = BUZZER_STATE_IDLE;
+    	buzzer->paused.state = BUZZER_STATE_IDLE;
+#if BUZZER_USE_ENVELOPE
+    	buzzer->env.phase = _ENV_OFF;
+#endif
+#if BUZZER_USE_SOFTPWM
+    	buzzer->softpwm.hz = 0;
+#endif
+#if BUZZER_USE_LFO
+    	buzzer->lfo.vibDepth = 0;
+    	buzzer->lfo.tremDepth = 0;
+    	buzzer->lfo.tremGain = 0xFF;
+    	buzzer->lfo.sounding = 0;
+#endif
+    	buzzer->env.level = 0xFF;
+    	buzzer->out.valid = 0;
+    	buzzer->out.elided = 0;
+    	if (_DETECT_ACTIVE(buzzer)){
     		buzzer->type = BUZZER_TYPE_ACTIVE;
-    		buzzer->fnx.gpioOut(0);
+    		__buzzer_gpio_write(buzzer, _LOW);
 
     		return BUZZER_ERR_OK;
     	}
-    	else if (buzzer->fnx.pwmOut){
+    	else if (_DETECT_PASSIVE(buzzer)){
     		buzzer->type = BUZZER_TYPE_PASSIVE;
-    		buzzer->fnx.pwmOut(0);
+    		__buzzer_pwm_write(buzzer, 0);
 
     		return BUZZER_ERR_OK;
     	}
@@ -153,67 +1370,385 @@ buzzer_err_e buzzer_init(buzzer_t *buzzer){
 
 void buzzer_stop(buzzer_t *buzzer){
     if (buzzer != NULL){
-        buzzer->active = BUZZER_IS_NOT_ACTIVE;
-        if (buzzer->type == BUZZER_TYPE_ACTIVE){
+        BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_STOP, 0);
+        __buzzer_effects_off(buzzer);
+        buzzer->paused.state = BUZZER_STATE_IDLE;
+        if (_IS_ACTIVE(buzzer)){
             __buzzer_stop_gpio(buzzer);
         }
-        else if (buzzer->type == BUZZER_TYPE_PASSIVE){
+        else if (_IS_PASSIVE(buzzer)){
             __buzzer_stop_pwm(buzzer);
         }
+        __buzzer_deactivate(buzzer);
     }
 }
 
+buzzer_err_e buzzer_pause(buzzer_t *buzzer){
+    if (buzzer == NULL || buzzer->state == BUZZER_STATE_IDLE){
+        return BUZZER_ERR_PARAMS;
+    }
+    // idle first, buzzer_interrupt() doesn't touch the instance anymore
+    buzzer->paused.state = buzzer->state;
+    buzzer->state = BUZZER_STATE_IDLE;
+#if BUZZER_USE_SEEK
+    buzzer->paused.seek = 0;
+#endif
+    buzzer->paused.freq = buzzer->out.freq;
+    buzzer->paused.gpio = buzzer->out.gpio;
+#if BUZZER_USE_SOFTPWM
+    buzzer->paused.pattern = buzzer->softpwm.pattern;
+#endif
+    // only the outputs, __buzzer_note_off() would end the effects
+    if (_IS_ACTIVE(buzzer)){
+#if BUZZER_USE_SOFTPWM
+        if (_SOFTPWM_ON(buzzer)){
+            buzzer->softpwm.pattern = 0;
+        }
+        else
+#endif
+        if (_HAS_GPIO(buzzer)){
+            __buzzer_gpio_write(buzzer, _LOW);
+        }
+    }
+    else if (_HAS_PWM(buzzer)){
+        __buzzer_pwm_write(buzzer, 0);
+    }
+    BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, 0);
+    __buzzer_deactivate(buzzer);
+
+    return BUZZER_ERR_OK;
+}
+
+buzzer_err_e buzzer_resume(buzzer_t *buzzer){
+#if BUZZER_USE_SEEK
+    uint_fast16_t i;
+    uint32_t start = 0;
+#endif
+
+    if (buzzer == NULL || buzzer->paused.state == BUZZER_STATE_IDLE){
+        return BUZZER_ERR_PARAMS;
+    }
+    __buzzer_activate(buzzer);
+#if BUZZER_USE_SEEK
+    if (buzzer->paused.seek){
+        // the note of the seek writes the outputs, the paused ones are old
+        buzzer->paused.seek = 0;
+        i = __buzzer_sequence_find(buzzer, buzzer->paused.seekMs, &start);
+        __buzzer_sequence_seek(buzzer, i, buzzer->paused.seekMs - start);
+        buzzer->state = buzzer->paused.state;
+        buzzer->paused.state = BUZZER_STATE_IDLE;
+
+        return BUZZER_ERR_OK;
+    }
+#endif
+    if (_IS_ACTIVE(buzzer)){
+#if BUZZER_USE_SOFTPWM
+        if (_SOFTPWM_ON(buzzer)){
+            buzzer->softpwm.pattern = buzzer->paused.pattern;
+        }
+        else
+#endif
+        if (_HAS_GPIO(buzzer)){
+            __buzzer_gpio_write(buzzer, buzzer->paused.gpio);
+        }
+    }
+    else if (_HAS_PWM(buzzer)){
+        __buzzer_pwm_write(buzzer, buzzer->paused.freq);
+    }
+    BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE,
+            _IS_ACTIVE(buzzer) ? buzzer->play_param.freq : buzzer->paused.freq);
+    // the state last, the outputs are restored before the next edge
+    buzzer->state = buzzer->paused.state;
+    buzzer->paused.state = BUZZER_STATE_IDLE;
+
+    return BUZZER_ERR_OK;
+}
+
 void buzzer_turn_on(buzzer_t *buzzer, uint16_t freq){
     if (buzzer != NULL){
-        buzzer->active = BUZZER_IS_ACTIVE;
+        __buzzer_trace_start(buzzer, freq);
+        __buzzer_enter(buzzer, BUZZER_STATE_HOLD);
+        // no notes, the state handler is never called
+        buzzer->play_param.time = INT_FAST32_MAX;
+        __buzzer_activate(buzzer);
         buzzer->play_param.loop = 0;
         buzzer->play_param.len = 0;
-        if (buzzer->type == BUZZER_TYPE_ACTIVE){
-            __buzzer_turn_on_gpio(buzzer);
+        __buzzer_effects_off(buzzer);
+        if (_IS_ACTIVE(buzzer)){
+            buzzer->play_param.freq = freq;
+            __buzzer_note_on_gpio(buzzer, freq);
         }
-        else if (buzzer->type == BUZZER_TYPE_PASSIVE){
+        else if (_IS_PASSIVE(buzzer)){
         	buzzer->play_param.freq = freq;
-            __buzzer_turn_on_pwm(buzzer, freq);
+        	buzzer->play_param.velocity = 0xFF;
+            __buzzer_note_on_pwm(buzzer, freq);
         }
     }
 }
 
 void buzzer_start(buzzer_t *buzzer, uint16_t freq, uint16_t period, buzzer_loop_e loop){
     if (buzzer != NULL){
+        __buzzer_trace_start(buzzer, freq);
         buzzer->play_param.i = 0;
         buzzer->play_param.time = period;
         buzzer->play_param.loop = loop;
-        buzzer->play_param.pTimes = NULL;
-        buzzer->play_param.pFreq = NULL;
-        buzzer->active = BUZZER_IS_ACTIVE;
+        __buzzer_effects_off(buzzer);
+        __buzzer_enter(buzzer, (loop == BUZZER_LOOP_ON) ? BUZZER_STATE_BLINK : BUZZER_STATE_TIMED);
+        __buzzer_activate(buzzer);
         buzzer->play_param.len = 2 + (loop == BUZZER_LOOP_ON);
-        if (buzzer->type == BUZZER_TYPE_ACTIVE){
+        if (_IS_ACTIVE(buzzer)){
+            buzzer->play_param.freq = freq;
             __buzzer_start_gpio(buzzer);
         }
-        else if (buzzer->type == BUZZER_TYPE_PASSIVE){
+        else if (_IS_PASSIVE(buzzer)){
         	buzzer->play_param.freq = freq;
+        	buzzer->play_param.velocity = 0xFF;
             __buzzer_start_pwm(buzzer);
         }
     }
 }
 
 void buzzer_start_array(buzzer_t *buzzer, uint16_t *pPeriod, uint16_t *pFreq, uint16_t len){
-    if (buzzer != NULL && pPeriod != NULL &&
-    		(pFreq != NULL || buzzer->type == BUZZER_TYPE_ACTIVE)){
-        buzzer->play_param.len = len;
+    buzzer_melody_t melody = {
+        .pTimes = pPeriod,
+        .pFreq = pFreq,
+        .pVelocity = NULL,
+        .len = len
+    };
+
+    buzzer_start_melody(buzzer, &melody);
+}
+
+void buzzer_start_melody(buzzer_t *buzzer, const buzzer_melody_t *melody){
+    if (buzzer != NULL && melody != NULL && melody->pTimes != NULL &&
+    		(melody->pFreq != NULL || _IS_ACTIVE(buzzer))){
+        __buzzer_trace_start(buzzer, (melody->pFreq != NULL) ? melody->pFreq[0] & BUZZER_FREQ_MASK : 0);
+        buzzer->play_param.len = melody->len;
         buzzer->play_param.i = 0;
-        buzzer->play_param.pTimes = pPeriod;
-        buzzer->play_param.pFreq = pFreq;
+        buzzer->play_param.pTimes = melody->pTimes;
+        buzzer->play_param.pFreq = melody->pFreq;
+        buzzer->play_param.pVelocity = melody->pVelocity;
+        buzzer->play_param.velocity = (melody->pVelocity != NULL) ? melody->pVelocity[0] : 0xFF;
+#if BUZZER_USE_ARTIC || BUZZER_USE_SEEK
+        buzzer->play_param.pArtic = melody->pArtic;
+        buzzer->play_param.artic = melody->artic;
+        buzzer->play_param.pIndex = melody->pIndex;
+#endif
+        __buzzer_effects_off(buzzer);
         buzzer->play_param.loop = BUZZER_LOOP_OFF;
-        buzzer->active = BUZZER_IS_ACTIVE;
-        if (buzzer->type == BUZZER_TYPE_ACTIVE){
+        __buzzer_enter(buzzer, BUZZER_STATE_SEQUENCE);
+        __buzzer_activate(buzzer);
+        if (_IS_ACTIVE(buzzer)){
             __buzzer_start_array_gpio(buzzer);
         }
-        else if (buzzer->type == BUZZER_TYPE_PASSIVE){
+        else if (_IS_PASSIVE(buzzer)){
             __buzzer_start_array_pwm(buzzer);
         }
+#if BUZZER_USE_ARTIC
+        __buzzer_artic_load(buzzer, 0);
+#endif
+    }
+}
+
+#if BUZZER_USE_PACKED
+void buzzer_start_packed(buzzer_t *buzzer, const uint8_t *pPacked){
+    uint16_t len;
+
+    if (buzzer != NULL && pPacked != NULL){
+        len = pPacked[2] | ((uint16_t)pPacked[3] << 8);
+        if (len == 0){
+            return;
+        }
+        __buzzer_trace_start(buzzer, __buzzer_packed_pitch(pPacked[BUZZER_PACKED_HEADER_LEN]));
+        buzzer->play_param.len = len;
+        buzzer->play_param.i = 0;
+        buzzer->play_param.pVelocity = NULL;
+        buzzer->play_param.velocity = 0xFF;
+        buzzer->play_param.pPacked = pPacked + BUZZER_PACKED_HEADER_LEN;
+        buzzer->play_param.packedWhole = pPacked[0] | ((uint16_t)pPacked[1] << 8);
+        buzzer->play_param.freq = 0;
+        __buzzer_effects_off(buzzer);
+        buzzer->play_param.loop = BUZZER_LOOP_OFF;
+        // the first note without a duration byte is a quarter
+        __buzzer_packed_duration(buzzer, 4);
+        __buzzer_enter(buzzer, BUZZER_STATE_PACKED);
+        __buzzer_activate(buzzer);
+        __buzzer_packed_note(buzzer);
+    }
+}
+#endif
+
+#if BUZZER_USE_PATTERN
+void buzzer_start_pattern(buzzer_t *buzzer, const buzzer_pattern_t *pattern){
+    if (buzzer != NULL && pattern != NULL){
+        __buzzer_trace_start(buzzer, pattern->freq);
+        buzzer->play_param.patMask = pattern->mask;
+        buzzer->play_param.patReload = pattern->mask;
+        buzzer->play_param.patBits = (pattern->bits & BUZZER_PATTERN_NBITS_MASK) + 1;
+        buzzer->play_param.patLeft = buzzer->play_param.patBits;
+        buzzer->play_param.patRepeat = pattern->bits >> BUZZER_PATTERN_REPEAT_SHIFT;
+        // none, the first slot always writes
+        buzzer->play_param.patOn = 0xFF;
+        buzzer->play_param.len = 0;
+        buzzer->play_param.freq = pattern->freq;
+        buzzer->play_param.pVelocity = NULL;
+        buzzer->play_param.velocity = 0xFF;
+        buzzer->play_param.time = __buzzer_ms_time(buzzer, pattern->slotMs);
+        buzzer->play_param.loop = BUZZER_LOOP_OFF;
+        __buzzer_effects_off(buzzer);
+        __buzzer_enter(buzzer, BUZZER_STATE_PATTERN);
+        __buzzer_activate(buzzer);
+        __buzzer_pattern_slot(buzzer);
+    }
+}
+#endif
+
+#if BUZZER_USE_BURST
+void buzzer_start_burst(buzzer_t *buzzer, const buzzer_burst_t *burst){
+    if (buzzer != NULL && burst != NULL){
+        __buzzer_trace_start(buzzer, burst->freq);
+        buzzer->play_param.burstOn = __buzzer_ms_time(buzzer, burst->onMs);
+        buzzer->play_param.burstOff = __buzzer_ms_time(buzzer, burst->offMs);
+        buzzer->play_param.burstPause = __buzzer_ms_time(buzzer, burst->pauseMs);
+        buzzer->play_param.burstPulses = (burst->pulses != 0) ? burst->pulses : 1;
+        buzzer->play_param.burstLeft = buzzer->play_param.burstPulses;
+        buzzer->play_param.burstRepeat = burst->repeat;
+        buzzer->play_param.i = 0;
+        buzzer->play_param.len = 0;
+        buzzer->play_param.time = buzzer->play_param.burstOn;
+        buzzer->play_param.freq = burst->freq;
+        buzzer->play_param.pVelocity = NULL;
+        buzzer->play_param.velocity = 0xFF;
+        buzzer->play_param.loop = BUZZER_LOOP_OFF;
+        __buzzer_effects_off(buzzer);
+        __buzzer_enter(buzzer, BUZZER_STATE_BURST);
+        __buzzer_activate(buzzer);
+        if (_IS_ACTIVE(buzzer)){
+            __buzzer_note_on_gpio(buzzer, burst->freq);
+        }
+        else if (_IS_PASSIVE(buzzer)){
+            __buzzer_note_on_pwm(buzzer, burst->freq);
+        }
+    }
+}
+#endif
+
+#if BUZZER_USE_MORSE
+void buzzer_start_morse(buzzer_t *buzzer, const buzzer_morse_t *morse){
+    uint32_t dit, charMs, wordMs, delay;
+    const char *p;
+    uint8_t code, space;
+
+    if (buzzer != NULL && morse != NULL && morse->text != NULL && morse->wpm != 0){
+        // a text without codes keeps the current play, so it isn't touched
+        // before the first code is found
+        p = morse->text;
+        code = __buzzer_morse_scan(&p, &space);
+        if (code == 0){
+            return;
+        }
+        dit = 1200 / morse->wpm;
+        charMs = 3 * dit;
+        wordMs = 7 * dit;
+        if (morse->farnsworthWpm != 0 && morse->farnsworthWpm < morse->wpm){
+            // ARRL Farnsworth timing, the delay that the 19 dits of
+            // gaps of "PARIS " take at the overall speed, in ms
+            delay = (60000UL * morse->wpm - 37200UL * morse->farnsworthWpm) /
+                    ((uint32_t)morse->wpm * morse->farnsworthWpm);
+            charMs = 3 * delay / 19;
+            wordMs = 7 * delay / 19;
+        }
+        __buzzer_trace_start(buzzer, morse->freq);
+        buzzer->play_param.morseDit = __buzzer_ms_time(buzzer, dit);
+        buzzer->play_param.morseDah = __buzzer_ms_time(buzzer, 3 * dit);
+        buzzer->play_param.morseChar = __buzzer_ms_time(buzzer, charMs);
+        buzzer->play_param.morseWord = __buzzer_ms_time(buzzer, wordMs);
+        buzzer->play_param.pText = p;
+        buzzer->play_param.morseCode = code;
+        buzzer->play_param.len = 0;
+        buzzer->play_param.freq = morse->freq;
+        buzzer->play_param.pVelocity = NULL;
+        buzzer->play_param.velocity = 0xFF;
+        buzzer->play_param.loop = BUZZER_LOOP_OFF;
+        __buzzer_effects_off(buzzer);
+        __buzzer_enter(buzzer, BUZZER_STATE_MORSE);
+        __buzzer_activate(buzzer);
+        __buzzer_morse_element(buzzer);
+    }
+}
+#endif
+
+#if BUZZER_USE_SEEK
+buzzer_err_e buzzer_melody_index(buzzer_t *buzzer, const buzzer_melody_t *melody, uint32_t *pIndex){
+    uint32_t ms = 0;
+    uint_fast16_t i;
+
+    if (buzzer == NULL || melody == NULL || melody->pTimes == NULL ||
+            pIndex == NULL || _TICK_MS(buzzer) == 0){
+        return BUZZER_ERR_PARAMS;
+    }
+    for (i = 0 ; i < melody->len ; i++){
+        pIndex[i] = ms;
+        ms += __buzzer_note_ms(buzzer, melody->pTimes[i]);
+    }
+    pIndex[i] = ms;
+
+    return BUZZER_ERR_OK;
+}
+
+uint32_t buzzer_get_duration_ms(buzzer_t *buzzer){
+    if (!__buzzer_seekable(buzzer)){
+        return 0;
+    }
+    return __buzzer_sequence_start_ms(buzzer, buzzer->play_param.len);
+}
+
+uint32_t buzzer_get_position_ms(buzzer_t *buzzer){
+    uint_fast16_t i;
+    uint32_t left;
+
+    if (!__buzzer_seekable(buzzer)){
+        return 0;
+    }
+    if (buzzer->state == BUZZER_STATE_IDLE && buzzer->paused.seek){
+        return buzzer->paused.seekMs;
+    }
+    i = buzzer->play_param.i;
+    // the note ends after its current part, and the rest of a cut
+    left = __buzzer_note_ms(buzzer, buzzer->play_param.time) - buzzer->counting;
+#if BUZZER_USE_ARTIC
+    if (buzzer->play_param.cut){
+        left += __buzzer_note_ms(buzzer, buzzer->play_param.rest);
+    }
+#endif
+    return __buzzer_sequence_start_ms(buzzer, i) +
+            __buzzer_note_ms(buzzer, buzzer->play_param.pTimes[i]) - left;
+}
+
+buzzer_err_e buzzer_seek_ms(buzzer_t *buzzer, uint32_t ms){
+    uint_fast16_t i;
+    uint32_t start = 0, offset;
+
+    if (!__buzzer_seekable(buzzer)){
+        return BUZZER_ERR_PARAMS;
+    }
+    i = __buzzer_sequence_find(buzzer, ms, &start);
+    if (i >= buzzer->play_param.len){
+        return BUZZER_ERR_PARAMS;
+    }
+    offset = ms - start;
+    offset -= offset % _TICK_MS(buzzer);
+    if (buzzer->state == BUZZER_STATE_IDLE){
+        // paused, the outputs are written by buzzer_resume()
+        buzzer->paused.seek = 1;
+        buzzer->paused.seekMs = start + offset;
+        return BUZZER_ERR_OK;
     }
+    __buzzer_sequence_seek(buzzer, i, offset);
+
+    return BUZZER_ERR_OK;
 }
+#endif
 
 buzzer_active_e buzzer_is_active(buzzer_t *buzzer){
     if (buzzer != NULL){
@@ -221,3 +1756,188 @@ buzzer_active_e buzzer_is_active(buzzer_t *buzzer){
     }
     return 0;
 }
+
+void buzzer_invalidate_output(buzzer_t *buzzer){
+    if (buzzer != NULL){
+        buzzer->out.valid = 0;
+#if BUZZER_USE_SOFTPWM
+        // the soft PWM keeps its own last level, a value that is never
+        // written makes the next interrupt write the pin
+        buzzer->softpwm.out = 0xFF;
+#endif
+    }
+}
+
+uint32_t buzzer_get_active_count(void){
+    return _activeCount;
+}
+
+uint32_t buzzer_get_elided_writes(buzzer_t *buzzer){
+    if (buzzer != NULL){
+        return buzzer->out.elided;
+    }
+    return 0;
+}
+
+#if BUZZER_USE_CHORDS
+void buzzer_start_chord_array(buzzer_t *buzzer, uint16_t *pPeriod, buzzer_chord_t *pChord, uint16_t len){
+    if (buzzer != NULL && pPeriod != NULL && pChord != NULL &&
+            len > 0 && _IS_PASSIVE(buzzer)){
+        __buzzer_trace_start(buzzer, pChord[0].freq[0]);
+        buzzer->play_param.len = len;
+        buzzer->play_param.i = 0;
+        buzzer->play_param.pTimes = pPeriod;
+        buzzer->play_param.pFreq = NULL;
+        buzzer->play_param.pVelocity = NULL;
+        buzzer->play_param.velocity = 0xFF;
+        buzzer->play_param.pChord = pChord;
+        buzzer->play_param.loop = BUZZER_LOOP_OFF;
+        __buzzer_effects_off(buzzer);
+        buzzer->play_param.arpTicks = 1;
+        if (buzzer->arpeggioMs > _TICK_MS(buzzer) && _TICK_MS(buzzer) > 0){
+            buzzer->play_param.arpTicks = buzzer->arpeggioMs / _TICK_MS(buzzer);
+        }
+        __buzzer_enter(buzzer, BUZZER_STATE_CHORDS);
+        __buzzer_activate(buzzer);
+        buzzer->play_param.time = pPeriod[0];
+        __buzzer_chord_load(buzzer, 0);
+    }
+}
+#endif
+
+#if BUZZER_USE_ENVELOPE
+buzzer_err_e buzzer_set_envelope(buzzer_t *buzzer, const buzzer_envelope_t *envelope){
+    if (buzzer == NULL || _TICK_MS(buzzer) == 0 ||
+            (envelope != NULL && !_HAS_DUTY(buzzer))){
+        return BUZZER_ERR_PARAMS;
+    }
+    buzzer->env.phase = _ENV_OFF;
+    buzzer->env.level = 0xFF;
+    buzzer->envelope = envelope;
+    if (envelope != NULL){
+        buzzer->env.div = 1;
+        if (envelope->updateMs > _TICK_MS(buzzer)){
+            buzzer->env.div = envelope->updateMs / _TICK_MS(buzzer);
+        }
+    }
+
+    return BUZZER_ERR_OK;
+}
+#endif
+
+#if BUZZER_USE_SOFTPWM
+buzzer_err_e buzzer_softpwm_init(buzzer_t *buzzer, uint32_t hz){
+    if (buzzer == NULL || hz == 0 || !_IS_ACTIVE(buzzer) ||
+            (buzzer->softpwm.pSet == NULL && !_HAS_GPIO(buzzer))){
+        return BUZZER_ERR_PARAMS;
+    }
+    buzzer->softpwm.pattern = 0;
+    buzzer->softpwm.phase = 0;
+    buzzer->softpwm.inc = 0;
+    buzzer->softpwm.out = _LOW;
+    buzzer->softpwm.level = BUZZER_SOFTPWM_LEVELS - 1;
+    buzzer->softpwm.hz = hz;
+
+    return BUZZER_ERR_OK;
+}
+
+void buzzer_set_volume(buzzer_t *buzzer, uint8_t level){
+    if (buzzer != NULL){
+        if (level >= BUZZER_SOFTPWM_LEVELS){
+            level = BUZZER_SOFTPWM_LEVELS - 1;
+        }
+        buzzer->softpwm.level = level;
+        if (buzzer->softpwm.pattern != 0){
+            buzzer->softpwm.pattern = _softpwmPattern[level];
+        }
+    }
+}
+
+void buzzer_softpwm_interrupt(buzzer_t *buzzer){
+    uint32_t pattern = buzzer->softpwm.pattern;
+    uint32_t out;
+
+    buzzer->softpwm.pattern = (pattern >> 1) | (pattern << 31);
+    buzzer->softpwm.phase += buzzer->softpwm.inc;
+    out = pattern & ~(buzzer->softpwm.phase >> 31) & 1;
+    if (out != buzzer->softpwm.out){
+        buzzer->softpwm.out = out;
+        if (buzzer->softpwm.pSet != NULL){
+            if (out)
+                *buzzer->softpwm.pSet = buzzer->softpwm.setMask;
+            else
+                *buzzer->softpwm.pClr = buzzer->softpwm.clrMask;
+        }
+        else{
+            _GPIO_OUT(buzzer, out);
+        }
+    }
+}
+#endif
+
+#if BUZZER_USE_LFO
+buzzer_err_e buzzer_set_vibrato(buzzer_t *buzzer, uint16_t rate, uint16_t depth, buzzer_lfo_wave_e wave){
+    if (!__buzzer_lfo_setup(buzzer) || wave > BUZZER_LFO_SQUARE || depth > 1000){
+        return BUZZER_ERR_PARAMS;
+    }
+    buzzer->lfo.vibWave = wave;
+    buzzer->lfo.vibPhase = 0;
+    buzzer->lfo.vibInc = __buzzer_lfo_inc(buzzer, rate);
+    // per mille and the +-127 of the waveform, folded in Q16
+    buzzer->lfo.vibDepth = ((uint32_t)depth << 16) / (1000 * 127);
+    if (depth == 0 && buzzer->lfo.sounding){
+        __buzzer_turn_on_pwm(buzzer, buzzer->play_param.freq);
+    }
+
+    return BUZZER_ERR_OK;
+}
+
+buzzer_err_e buzzer_set_tremolo(buzzer_t *buzzer, uint16_t rate, uint8_t depth, buzzer_lfo_wave_e wave){
+    if (!__buzzer_lfo_setup(buzzer) || wave > BUZZER_LFO_SQUARE ||
+            !_HAS_DUTY(buzzer)){
+        return BUZZER_ERR_PARAMS;
+    }
+    buzzer->lfo.tremWave = wave;
+    buzzer->lfo.tremPhase = 0;
+    buzzer->lfo.tremInc = __buzzer_lfo_inc(buzzer, rate);
+    buzzer->lfo.tremDepth = depth;
+    buzzer->lfo.tremGain = 0xFF;
+    if (depth == 0 && buzzer->lfo.sounding){
+        __buzzer_duty_out(buzzer);
+    }
+
+    return BUZZER_ERR_OK;
+}
+#endif
+
+#if BUZZER_USE_SFX
+void buzzer_start_sfx(buzzer_t *buzzer, const buzzer_sfx_t *sfx){
+    if (buzzer != NULL && sfx != NULL && _TICK_MS(buzzer) > 0 &&
+            _IS_PASSIVE(buzzer)){
+        __buzzer_trace_start(buzzer, sfx->baseFreq);
+        buzzer->play_param.len = 0;
+        buzzer->play_param.velocity = 0xFF;
+        __buzzer_effects_off(buzzer);
+#if BUZZER_USE_ENVELOPE
+        buzzer->env.phase = _ENV_OFF;
+#endif
+        buzzer->sfx.div = 1;
+        if (sfx->stepMs > _TICK_MS(buzzer)){
+            buzzer->sfx.div = sfx->stepMs / _TICK_MS(buzzer);
+        }
+        buzzer->sfx.cnt = buzzer->sfx.div;
+        buzzer->sfx.p = sfx;
+        buzzer->sfx.duty = (uint32_t)sfx->duty << 4;
+        __buzzer_sfx_restart(buzzer);
+        __buzzer_sfx_phase(buzzer, _SFX_ATTACK);
+        __buzzer_enter(buzzer, BUZZER_STATE_SFX);
+        // no notes, the state handler is never called
+        buzzer->play_param.time = INT_FAST32_MAX;
+        __buzzer_activate(buzzer);
+        __buzzer_sfx_out(buzzer);
+#if BUZZER_USE_LFO
+        buzzer->lfo.sounding = 1;
+#endif
+    }
+}
+#endif
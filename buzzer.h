@@ -20,6 +20,184 @@
 #include "notes.h"
 #include "ringtones.h"
 
+/*
+ * Configuration
+ */
+
+/**
+ * @brief optional header of the port, included before the configuration,
+ * where the macros below and the static outputs are defined, e.g.
+ * -DBUZZER_PORT_HEADER=\"buzzer_port.h\"
+ */
+#ifdef BUZZER_PORT_HEADER
+#include BUZZER_PORT_HEADER
+#endif
+
+/**
+ * @brief compile time type of the devices. When every buzzer of the board
+ * has the same type, set BUZZER_STATIC_TYPE to BUZZER_STATIC_PASSIVE or
+ * BUZZER_STATIC_ACTIVE and the type branches of the engine are folded by
+ * the compiler. 0 (default) detects the type on buzzer_init()
+ */
+#define BUZZER_STATIC_PASSIVE	1
+#define BUZZER_STATIC_ACTIVE	2
+#ifndef BUZZER_STATIC_TYPE
+#define BUZZER_STATIC_TYPE		0
+#endif
+
+/**
+ * @brief compile time tick, in ms. When not 0, replaces interruptMs in
+ * the engine, so the divisions by the tick are done by the compiler
+ */
+#ifndef BUZZER_STATIC_INTERRUPT_MS
+#define BUZZER_STATIC_INTERRUPT_MS	0
+#endif
+
+/*
+ * Statically bound outputs, define them in the port header to call the
+ * driver directly (and inline it) instead of the fnx pointers, that are
+ * then ignored. Shared by every instance:
+ *
+ *  #define BUZZER_PWM_OUT(freq)    port_pwm_out(freq)
+ *  #define BUZZER_DUTY_OUT(duty)   port_duty_out(duty)
+ *  #define BUZZER_GPIO_OUT(val)    port_gpio_out(val)
+ */
+
+/**
+ * @brief modes and effects compiled in, set to 0 to remove one from the
+ * library, its functions are then not declared and its fields are
+ * removed from buzzer_t
+ */
+#ifndef BUZZER_USE_CHORDS
+#define BUZZER_USE_CHORDS		1
+#endif
+#ifndef BUZZER_USE_ENVELOPE
+#define BUZZER_USE_ENVELOPE		1
+#endif
+#ifndef BUZZER_USE_GLIDE
+#define BUZZER_USE_GLIDE		1
+#endif
+#ifndef BUZZER_USE_LFO
+#define BUZZER_USE_LFO			1
+#endif
+#ifndef BUZZER_USE_SFX
+#define BUZZER_USE_SFX			1
+#endif
+#ifndef BUZZER_USE_SOFTPWM
+#define BUZZER_USE_SOFTPWM		1
+#endif
+#ifndef BUZZER_USE_PACKED
+#define BUZZER_USE_PACKED		1
+#endif
+#ifndef BUZZER_USE_ARTIC
+#define BUZZER_USE_ARTIC		1
+#endif
+#ifndef BUZZER_USE_PATTERN
+#define BUZZER_USE_PATTERN		1
+#endif
+#ifndef BUZZER_USE_BURST
+#define BUZZER_USE_BURST		1
+#endif
+#ifndef BUZZER_USE_MORSE
+#define BUZZER_USE_MORSE		1
+#endif
+#ifndef BUZZER_USE_SEEK
+#define BUZZER_USE_SEEK			1
+#endif
+
+/**
+ * @brief set to 1 to record the engine events on buzzer_trace,
+ * see buzzer_trace.h. When 0, the trace has no cost at all
+ */
+#ifndef BUZZER_USE_TRACE
+#define BUZZER_USE_TRACE		0
+#endif
+
+/**
+ * @brief critical section of the counters shared by the interrupt and the
+ * application (the active count and the trace head), define both in
+ * the port header for the target, e.g. with the RTOS or the HAL. By
+ * default the interrupts are masked on Cortex-M (PRIMASK, saved and
+ * restored, so it nests), and nothing is done on the other targets, that
+ * must define them when the library is called from more than one
+ * context. No atomic instruction is needed, so it builds on ARMv6-M
+ * without libatomic
+ */
+#ifndef BUZZER_CRITICAL_ENTER
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+#define BUZZER_CRITICAL_ENTER()		uint32_t _buzzerPrimask; \
+		__asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (_buzzerPrimask) :: "memory")
+#define BUZZER_CRITICAL_EXIT()		__asm volatile ("msr primask, %0" :: "r" (_buzzerPrimask) : "memory")
+#else
+#define BUZZER_CRITICAL_ENTER()
+#define BUZZER_CRITICAL_EXIT()
+#endif
+#endif
+
+/**
+ * @brief max number of frequencies of a chord, see buzzer_start_chord_array()
+ */
+#ifndef BUZZER_CHORD_MAX
+#define BUZZER_CHORD_MAX		4
+#endif
+
+/**
+ * @brief number of points of the envelope curves, must be 32
+ */
+#define BUZZER_ENV_LEN			32
+
+/**
+ * @brief number of volume levels of the soft PWM, see buzzer_set_volume()
+ */
+#define BUZZER_SOFTPWM_LEVELS	9
+
+/**
+ * @brief glide flags of the pFreq values. A note marked with
+ * BUZZER_GLIDE_LIN() or BUZZER_GLIDE_EXP() slides from the previous note
+ * frequency, linearly (in Hz) or exponentially (in pitch), see glideMs
+ */
+#define BUZZER_FREQ_MASK		0x3FFF
+#define BUZZER_GLIDE_FLAG		0x8000
+#define BUZZER_GLIDE_EXP_FLAG	0x4000
+#define BUZZER_GLIDE_LIN(freq)	((freq) | BUZZER_GLIDE_FLAG)
+#define BUZZER_GLIDE_EXP(freq)	((freq) | BUZZER_GLIDE_FLAG | BUZZER_GLIDE_EXP_FLAG)
+
+/**
+ * @brief packed melody format, see buzzer_start_packed(). A header of
+ * BUZZER_PACKED_HEADER_LEN bytes, the whole note in ms and the number of
+ * notes (both uint16_t, little endian), then one byte per note: the
+ * pitch index (0 is a rest, 1 is NOTE_B0 up to BUZZER_PACKED_PITCHES - 1,
+ * NOTE_DS8, in semitones), and BUZZER_PACKED_DUR_FLAG when a duration
+ * byte follows. The duration byte is the divisor of the whole note (4 is
+ * a quarter), with BUZZER_PACKED_DOT_FLAG for dotted notes. Notes without
+ * a duration byte keep the previous duration, the first one a quarter
+ */
+#define BUZZER_PACKED_HEADER_LEN	4
+#define BUZZER_PACKED_PITCHES		90
+#define BUZZER_PACKED_PITCH_MASK	0x7F
+#define BUZZER_PACKED_DUR_FLAG		0x80
+#define BUZZER_PACKED_DIV_MASK		0x7F
+#define BUZZER_PACKED_DOT_FLAG		0x80
+
+/**
+ * @brief bits field of buzzer_pattern_t, the number of bits of the mask
+ * (1 to 32) and how many times the mask is repeated after the first play
+ * (0 to 6, or BUZZER_PATTERN_FOREVER until buzzer_stop())
+ */
+#define BUZZER_PATTERN_NBITS_MASK	0x1F
+#define BUZZER_PATTERN_REPEAT_SHIFT	5
+#define BUZZER_PATTERN_FOREVER		7
+#define BUZZER_PATTERN_BITS(nbits, repeat)	((((nbits) - 1) & BUZZER_PATTERN_NBITS_MASK) | \
+											((repeat) << BUZZER_PATTERN_REPEAT_SHIFT))
+
+/**
+ * @brief repeat of buzzer_burst_t that plays the bursts until
+ * buzzer_stop()
+ */
+#define BUZZER_BURST_FOREVER		0
+
+#include "buzzer_trace.h"
+
 /*
  * Enumerates
  */
@@ -60,6 +238,48 @@ typedef enum{
 	BUZZER_IS_ACTIVE
 }buzzer_active_e;
 
+/**
+ * @brief what the instance is playing, each state has its handler on
+ * buzzer_interrupt(). Set by the start functions
+ *
+ * BUZZER_STATE_IDLE : nothing, buzzer_interrupt() returns at once
+ * BUZZER_STATE_HOLD : buzzer_turn_on(), sounds until buzzer_stop()
+ * BUZZER_STATE_TIMED : buzzer_start() with BUZZER_LOOP_OFF
+ * BUZZER_STATE_BLINK : buzzer_start() with BUZZER_LOOP_ON
+ * BUZZER_STATE_SEQUENCE : buzzer_start_array() and buzzer_start_melody()
+ * BUZZER_STATE_CHORDS : buzzer_start_chord_array()
+ * BUZZER_STATE_PACKED : buzzer_start_packed()
+ * BUZZER_STATE_PATTERN : buzzer_start_pattern()
+ * BUZZER_STATE_BURST : buzzer_start_burst()
+ * BUZZER_STATE_MORSE : buzzer_start_morse()
+ * BUZZER_STATE_SFX : buzzer_start_sfx()
+ */
+typedef enum{
+	BUZZER_STATE_IDLE,
+	BUZZER_STATE_HOLD,
+	BUZZER_STATE_TIMED,
+	BUZZER_STATE_BLINK,
+	BUZZER_STATE_SEQUENCE,
+	BUZZER_STATE_CHORDS,
+	BUZZER_STATE_PACKED,
+	BUZZER_STATE_PATTERN,
+	BUZZER_STATE_BURST,
+	BUZZER_STATE_MORSE,
+	BUZZER_STATE_SFX,
+
+	BUZZER_STATE_COUNT
+}buzzer_state_e;
+
+/**
+ * @brief waveform of the LFOs, see buzzer_set_vibrato() and
+ * buzzer_set_tremolo()
+ */
+typedef enum{
+	BUZZER_LFO_SINE,
+	BUZZER_LFO_TRIANGLE,
+	BUZZER_LFO_SQUARE
+}buzzer_lfo_wave_e;
+
 /**
  * BUZZER_ERR_OK : Eveything is OK
  * BUZZER_ERR_FAIL : failed to initialize the buzzer
@@ -84,12 +304,129 @@ typedef enum{
  */
 typedef void (*pwmOutFx)(uint32_t freq);
 typedef void (*gpioOutFx)(uint32_t val);
+/**
+ * @brief Function pointer to set the PWM duty cycle, from 0 to 100 (%)
+ */
+typedef void (*pwmDutyOutFx)(uint32_t duty);
 
 
 /*
  * Structs and Unions
  */
 
+/**
+ * @brief a note event with up to BUZZER_CHORD_MAX frequencies, played
+ * as a fast arpeggio on a single buzzer. Unused frequencies must be 0,
+ * and a chord with freq[0] = 0 is a rest
+ */
+typedef struct{
+    uint16_t freq[BUZZER_CHORD_MAX];
+}buzzer_chord_t;
+
+/**
+ * @brief amplitude envelope (ADSR) of the notes, applied through the
+ * duty cycle. Can be const, only the pointer is kept, see
+ * buzzer_set_envelope()
+ */
+typedef struct{
+    uint16_t attackMs;      // time to rise from 0 to the peak
+    uint16_t decayMs;       // time to fall from the peak to sustain
+    uint16_t releaseMs;     // time to fall to 0, at the end of the note
+    uint8_t sustain;        // sustain level, 255 is the peak
+    uint8_t dutyMax;        // duty cycle of the peak, in %, 50 is the loudest
+    uint16_t updateMs;      // period of the envelope updates, rounded down
+                            // to interruptMs. 0 updates on every interrupt
+}buzzer_envelope_t;
+
+/**
+ * @brief parameters of a procedural sound effect (sfxr style), see
+ * buzzer_start_sfx(). 16 bytes, generally const. Each step, every
+ * stepMs, applies the slides and sweeps
+ */
+typedef struct{
+    uint16_t baseFreq;      // start frequency, in Hz
+    int16_t slide;          // frequency change per step, in 1/16 Hz
+    int8_t deltaSlide;      // slide change per step, in 1/16 Hz
+    uint8_t minFreq;        // ends when the frequency falls below, in 10Hz
+    uint8_t duty;           // start duty cycle, in %, from 1 to 50
+    int8_t dutySweep;       // duty cycle change per step, in 1/16 %
+    uint8_t arpMul;         // arpeggio jump, multiplies the frequency by
+                            // arpMul/16 (32 is one octave up), 0 is off
+    uint8_t arpSteps;       // steps until the arpeggio jump
+    uint8_t repeatSteps;    // steps until the frequency, slide and
+                            // arpeggio restart, 0 is off
+    uint8_t attack;         // volume envelope, in 8ms units
+    uint8_t sustain;
+    uint8_t decay;
+    uint8_t punch;          // extra volume at the sustain start, in %
+    uint8_t stepMs;         // period of the steps, rounded down to
+                            // interruptMs. 0 is every interrupt
+}buzzer_sfx_t;
+
+/**
+ * @brief a melody for buzzer_start_melody(). Only pTimes is mandatory,
+ * the other arrays can be NULL
+ */
+typedef struct{
+    uint16_t *pTimes;       // period of each note
+    uint16_t *pFreq;        // frequency of each note, 0 is a rest
+    uint8_t *pVelocity;     // velocity of each note, 255 is the loudest,
+                            // written as duty by fnx.pwmDutyOut, with or
+                            // without an envelope. NULL plays all the
+                            // notes with 255
+    uint16_t len;           // number of notes
+    uint8_t *pArtic;        // articulation of each note, the % of the
+                            // period that sounds, the rest is silent.
+                            // 0 uses artic. NULL uses artic for all notes
+    uint8_t artic;          // default articulation, 0 or 100 is legato
+    const uint32_t *pIndex; // start of each note in ms, len + 1 values,
+                            // see buzzer_melody_index(). NULL makes the
+                            // position and the seeks scan the pTimes
+}buzzer_melody_t;
+
+/**
+ * @brief an on/off pattern for buzzer_start_pattern(), in 8 bytes. Each
+ * bit of the mask is a slot of slotMs, from the bit 0: 1 sounds and 0 is
+ * silent
+ */
+typedef struct{
+    uint32_t mask;
+    uint16_t freq;          // frequency of the slots that sound, for
+                            // Passive devices and the soft PWM
+    uint8_t slotMs;         // duration of each bit
+    uint8_t bits;           // BUZZER_PATTERN_BITS(nbits, repeat)
+}buzzer_pattern_t;
+
+/**
+ * @brief a burst for buzzer_start_burst(): pulses of onMs with offMs
+ * between them, and a pauseMs after the last one, repeated. The alarm
+ * signals of IEC 60601-1-8, for instance, are bursts of pulses
+ */
+typedef struct{
+    uint16_t freq;          // frequency of the pulses, for Passive
+                            // devices and the soft PWM
+    uint16_t onMs;          // duration of each pulse
+    uint16_t offMs;         // silence between the pulses of a burst
+    uint16_t pauseMs;       // silence after the last pulse of a burst
+    uint8_t pulses;         // pulses of a burst, 0 is 1
+    uint8_t repeat;         // number of bursts, or BUZZER_BURST_FOREVER
+}buzzer_burst_t;
+
+/**
+ * @brief a text for buzzer_start_morse(). The speed is in words per
+ * minute of "PARIS", a dit lasts 1200 / wpm ms. With a farnsworthWpm
+ * below wpm, the characters keep the wpm speed and only the gaps between
+ * characters and words are stretched, to the farnsworthWpm speed
+ */
+typedef struct{
+    const char *text;       // letters, digits, punctuation and spaces,
+                            // must be kept valid. Others are skipped
+    uint16_t freq;          // frequency of the dits and dahs, for
+                            // Passive devices and the soft PWM
+    uint8_t wpm;            // speed of the characters
+    uint8_t farnsworthWpm;  // overall speed, 0 is wpm
+}buzzer_morse_t;
+
 typedef struct{
 	// user must define these parameters
     struct{
@@ -108,28 +445,228 @@ typedef struct{
     	gpioOutFx gpioOut;
 
         // Jut pick only one function, the other must be NULL
+
+        /**
+         * @brief Optional, function to handle with the PWM duty
+         * cycle, used by the envelope. The pwmOut must keep the
+         * duty cycle when changing the frequency
+         */
+        pwmDutyOutFx pwmDutyOut;
     }fnx;
 
     // the interrupt period that you will call buzzer_interrupt()
     // necessary for buzzer_start() and buzzer_start_array()
     uint_fast16_t interruptMs;
+#if BUZZER_USE_CHORDS
+    // time that each chord note sounds on buzzer_start_chord_array(),
+    // rounded down to interruptMs. 0 rotates on every interrupt
+    uint_fast16_t arpeggioMs;
+#endif
+#if BUZZER_USE_GLIDE
+    // duration of the glides, 0 glides over the whole note
+    uint_fast16_t glideMs;
+    // period of the glide frequency updates, rounded down to
+    // interruptMs. 0 updates on every interrupt
+    uint_fast16_t glideStepMs;
+#endif
+#if BUZZER_USE_LFO
+    // period of the vibrato and tremolo updates, rounded down to
+    // interruptMs. 0 updates on every interrupt
+    uint_fast16_t lfoMs;
+#endif
+#if BUZZER_USE_ENVELOPE
+    // amplitude envelope, set with buzzer_set_envelope()
+    const buzzer_envelope_t *envelope;
+#endif
+#if BUZZER_USE_SOFTPWM
+    // soft PWM of Active devices, see buzzer_softpwm_init()
+    struct{
+        // optional, registers to set and to clear the pin, with one
+        // store each (e.g. pSet = pClr = &GPIOx->BSRR, setMask = pin,
+        // clrMask = pin << 16). When NULL the gpioOut is used
+        volatile uint32_t *pSet;
+        volatile uint32_t *pClr;
+        uint32_t setMask;
+        uint32_t clrMask;
+
+        // internal library variables
+        uint32_t hz;
+        uint32_t pattern;
+        uint32_t phase;
+        uint32_t inc;
+        uint8_t level;
+        uint8_t out;
+    }softpwm;
+#endif
 
     // internal library variables, no need to work with these
     uint8_t started;
+#if BUZZER_USE_TRACE
+    uint8_t traceId;
+#endif
     buzzer_type_e type;
     buzzer_active_e active;
+    uint8_t state;
     uint_fast16_t counting;
+    // the state and the outputs of buzzer_pause(), restored by
+    // buzzer_resume(). state is BUZZER_STATE_IDLE when not paused
+    struct{
+        uint8_t state;
+        uint8_t gpio;
+        uint32_t freq;
+#if BUZZER_USE_SOFTPWM
+        uint32_t pattern;
+#endif
+#if BUZZER_USE_SEEK
+        // buzzer_seek_ms() while paused, done by buzzer_resume()
+        uint8_t seek;
+        uint32_t seekMs;
+#endif
+    }paused;
     struct{
         uint16_t *pTimes;
         uint16_t *pFreq;
+        uint8_t *pVelocity;
         uint_fast16_t i;
         uint_fast16_t len;
 
         int_fast32_t time;
         uint_fast16_t freq;
+        uint8_t velocity;
 
         buzzer_loop_e loop;
+
+#if BUZZER_USE_CHORDS
+        // arpeggio of the chords, arpN is 0 on the other modes
+        buzzer_chord_t *pChord;
+        uint16_t *pArp;
+        uint8_t arpN;
+        uint8_t arpI;
+        uint_fast16_t arpTicks;
+        uint_fast16_t arpCnt;
+#endif
+
+#if BUZZER_USE_ARTIC || BUZZER_USE_SEEK || BUZZER_USE_PACKED || \
+		BUZZER_USE_PATTERN || BUZZER_USE_BURST || BUZZER_USE_MORSE
+        // each mode only uses its own fields, set by its start. The union and
+        // its structs are anonymous, a C11 feature (or the GNU C99 extension),
+        // so the fields are named as play_param.pPacked and alike
+        union{
+#if BUZZER_USE_ARTIC || BUZZER_USE_SEEK
+            struct{
+                uint8_t *pArtic;
+                const uint32_t *pIndex;
+                uint8_t artic;
+                uint8_t cut;
+                int_fast32_t rest;
+            };
+#endif
+#if BUZZER_USE_PACKED
+            struct{
+                const uint8_t *pPacked;
+                uint16_t packedWhole;
+                int_fast32_t packedMs;
+            };
+#endif
+#if BUZZER_USE_PATTERN
+            struct{
+                uint32_t patMask;
+                uint32_t patReload;
+                uint8_t patBits;
+                uint8_t patLeft;
+                uint8_t patRepeat;
+                uint8_t patOn;
+            };
+#endif
+#if BUZZER_USE_BURST
+            struct{
+                int_fast32_t burstOn;
+                int_fast32_t burstOff;
+                int_fast32_t burstPause;
+                uint8_t burstPulses;
+                uint8_t burstLeft;
+                uint8_t burstRepeat;
+            };
+#endif
+#if BUZZER_USE_MORSE
+            struct{
+                const char *pText;
+                uint8_t morseCode;
+                int_fast32_t morseDit;
+                int_fast32_t morseDah;
+                int_fast32_t morseChar;
+                int_fast32_t morseWord;
+            };
+#endif
+        };
+#endif
     }play_param;
+#if BUZZER_USE_GLIDE
+    struct{
+        uint8_t exp;
+        uint_fast16_t steps;
+        uint32_t pos;
+        int32_t inc;
+        uint32_t to;
+        uint_fast16_t div;
+        uint_fast16_t cnt;
+    }glide;
+#endif
+#if BUZZER_USE_SFX
+    struct{
+        const buzzer_sfx_t *p;
+        uint32_t freq;
+        int32_t slide;
+        int32_t duty;
+        uint32_t vol;
+        uint32_t volInc;
+        uint16_t steps;
+        uint16_t arpCnt;
+        uint16_t repCnt;
+        uint8_t phase;
+        uint_fast16_t div;
+        uint_fast16_t cnt;
+    }sfx;
+#endif
+#if BUZZER_USE_LFO
+    struct{
+        uint32_t vibPhase;
+        uint32_t vibInc;
+        int32_t vibDepth;
+        uint8_t vibWave;
+        uint32_t tremPhase;
+        uint32_t tremInc;
+        uint8_t tremDepth;
+        uint8_t tremWave;
+        uint8_t tremGain;
+        uint8_t sounding;
+        uint_fast16_t div;
+        uint_fast16_t cnt;
+    }lfo;
+#endif
+    // duty of the notes, the level and the gain are also used by the
+    // velocity and the sound effects
+    struct{
+        uint8_t level;
+        uint32_t gain;
+#if BUZZER_USE_ENVELOPE
+        uint8_t phase;
+        uint8_t relLevel;
+        uint32_t acc;
+        uint32_t inc;
+        uint_fast16_t div;
+        uint_fast16_t cnt;
+#endif
+    }env;
+    // last values written to the driver, the same value isn't written
+    // again, see buzzer_invalidate_output()
+    struct{
+        uint32_t freq;
+        uint32_t duty;
+        uint8_t gpio;
+        uint8_t valid;
+        uint32_t elided;
+    }out;
 }buzzer_t;
 
 /*
@@ -137,7 +674,9 @@ typedef struct{
  */
 
 /**
- * @brief Initialize the buzzer
+ * @brief Initialize the buzzer. The handle must be zeroed before the first
+ * call (a global, or = {0}), a play that is running when it is called
+ * again is dropped and leaves the active count
  * 
  * @param buzzer : pointer to the handle of the buzzer
  * @return buzzer_err_e 
@@ -197,13 +736,309 @@ void buzzer_start(buzzer_t *buzzer, uint16_t freq, uint16_t period, buzzer_loop_
  * 
  * @param buzzer : pointer to the handle of the buzzer
  * @param pPeriod : array of period
- * @param pFreq : array of frequency values, must have the same len of pPeriod
+ * @param pFreq : array of frequency values, must have the same len of pPeriod.
+ * The values can be marked with BUZZER_GLIDE_LIN() or BUZZER_GLIDE_EXP()
  * @param len : number of values on pFreq and/or pPeriod
  * 
  * @note pFreq is relevant only for Passive devices
  */
 void buzzer_start_array(buzzer_t *buzzer, uint16_t *pPeriod, uint16_t *pFreq, uint16_t len);
 
+#if BUZZER_USE_CHORDS
+/**
+ * @brief Start to play an array of chords, each chord is played as a fast
+ * arpeggio, rotating among its frequencies every arpeggioMs. Arpeggios of
+ * 15 to 60Hz sound as a chord. buzzer_interrupt must be working, and its
+ * period must be short enough for the arpeggio
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param pPeriod : array of period
+ * @param pChord : array of chords, must have the same len of pPeriod
+ * @param len : number of values on pChord and pPeriod
+ *
+ * @note only for Passive devices
+ */
+void buzzer_start_chord_array(buzzer_t *buzzer, uint16_t *pPeriod, buzzer_chord_t *pChord, uint16_t len);
+#endif
+
+/**
+ * @brief Start to play a melody, like buzzer_start_array(), but with the
+ * optional per note velocity. buzzer_interrupt must be working
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param melody : pointer to the melody, only the arrays pointers are
+ * kept, so it can be a local variable
+ *
+ * @note pFreq and pVelocity are relevant only for Passive devices. The
+ * articulation silences the notes on both types, see tools/buzzer_artic.c
+ * to fold the rests of a melody into it
+ */
+void buzzer_start_melody(buzzer_t *buzzer, const buzzer_melody_t *melody);
+
+#if BUZZER_USE_PACKED
+/**
+ * @brief Start to play a packed melody, generally built at compile time
+ * by the C++ literals of buzzer.hpp. About 1 byte per note, against the
+ * 4 of buzzer_start_array(), decoded note by note on buzzer_interrupt().
+ * buzzer_interrupt must be working
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param pPacked : the melody, see BUZZER_PACKED_HEADER_LEN, must be kept
+ * valid
+ *
+ * @note the pitches are relevant only for Passive devices
+ */
+void buzzer_start_packed(buzzer_t *buzzer, const uint8_t *pPacked);
+#endif
+
+#if BUZZER_USE_PATTERN
+/**
+ * @brief Start to play an on/off pattern, one bit of the mask per slot,
+ * shifted out on buzzer_interrupt(). Slots of equal bits don't write the
+ * outputs. buzzer_interrupt must be working
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param pattern : pointer to the pattern, it's copied, so it can be a
+ * local variable
+ *
+ * @note the slots are rounded down to interruptMs, at least one interrupt
+ */
+void buzzer_start_pattern(buzzer_t *buzzer, const buzzer_pattern_t *pattern);
+#endif
+
+#if BUZZER_USE_BURST
+/**
+ * @brief Start to play bursts of pulses, with different on and off times
+ * and a pause between the bursts. buzzer_end_callback() is called at the
+ * end of the last pulse of the last burst. buzzer_interrupt must be
+ * working
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param burst : pointer to the burst, it's copied, so it can be a local
+ * variable
+ *
+ * @note the times are rounded down to interruptMs, at least one interrupt
+ */
+void buzzer_start_burst(buzzer_t *buzzer, const buzzer_burst_t *burst);
+#endif
+
+#if BUZZER_USE_MORSE
+/**
+ * @brief Start to play a text in Morse code. The text is encoded one
+ * character at a time from a table, during the gap before it, so no
+ * array is built and the RAM doesn't depend on the text length.
+ * buzzer_interrupt must be working
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param morse : pointer to the text and the speeds, it's copied, so it
+ * can be a local variable. The text must be kept valid
+ *
+ * @note the dits and the gaps are rounded down to interruptMs, choose a
+ * wpm that gives a dit multiple of it for exact timings
+ */
+void buzzer_start_morse(buzzer_t *buzzer, const buzzer_morse_t *morse);
+#endif
+
+#if BUZZER_USE_SEEK
+/**
+ * @brief Build the index of a melody for the seeks, the start of each
+ * note in ms as played with the interruptMs of the buzzer, and the
+ * duration of the melody at pIndex[len]. Point melody->pIndex to it
+ * before buzzer_start_melody(), it can also be a const table
+ *
+ * @param buzzer : pointer to the handle of the buzzer, for interruptMs
+ * @param melody : pointer to the melody
+ * @param pIndex : array of melody->len + 1 values
+ * @return buzzer_err_e
+ */
+buzzer_err_e buzzer_melody_index(buzzer_t *buzzer, const buzzer_melody_t *melody, uint32_t *pIndex);
+
+/**
+ * @brief Return the total time of the array or melody that is playing,
+ * in ms
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @return uint32_t, 0 when no array or melody is playing or paused
+ */
+uint32_t buzzer_get_duration_ms(buzzer_t *buzzer);
+
+/**
+ * @brief Return the time played of the array or melody, in ms
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @return uint32_t, 0 when no array or melody is playing or paused
+ *
+ * @note with the pIndex of the melody it costs a few loads, without it
+ * the pTimes before the current note are summed
+ */
+uint32_t buzzer_get_position_ms(buzzer_t *buzzer);
+
+/**
+ * @brief Jump to a time of the array or melody that is playing. The note
+ * of that time starts at once, and ends when it would without the seek.
+ * While paused, the outputs stay silent and the note starts on
+ * buzzer_resume(), the position is already the new time
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param ms : the time from the start of the melody, rounded down to
+ * interruptMs
+ * @return buzzer_err_e, BUZZER_ERR_PARAMS when no array or melody is
+ * playing or paused, or ms is beyond its end
+ *
+ * @note a binary search on the pIndex of the melody, or a scan of the
+ * pTimes without it. Don't call it while buzzer_interrupt() can run
+ */
+buzzer_err_e buzzer_seek_ms(buzzer_t *buzzer, uint32_t ms);
+#endif
+
+#if BUZZER_USE_ENVELOPE
+/**
+ * @brief Set the amplitude envelope of the notes. Each note starts with
+ * the attack and decay, holds the sustain, and ends with the release.
+ * The duty is written through fnx.pwmDutyOut, from precomputed curves,
+ * every envelope->updateMs
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param envelope : pointer to the envelope, must be kept valid. NULL
+ * disables the envelope
+ * @return buzzer_err_e
+ *
+ * @note only for Passive devices with fnx.pwmDutyOut
+ */
+buzzer_err_e buzzer_set_envelope(buzzer_t *buzzer, const buzzer_envelope_t *envelope);
+#endif
+
+#if BUZZER_USE_SFX
+/**
+ * @brief Start a procedural sound effect (coin, laser, jump, ...), the
+ * frequency and duty cycle are computed on the fly by buzzer_interrupt,
+ * from the parameters. Ends with buzzer_end_callback()
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param sfx : pointer to the parameters, must be kept valid
+ *
+ * @note only for Passive devices, the volume envelope and the duty cycle
+ * need fnx.pwmDutyOut
+ */
+void buzzer_start_sfx(buzzer_t *buzzer, const buzzer_sfx_t *sfx);
+#endif
+
+#if BUZZER_USE_LFO
+/**
+ * @brief Set the vibrato, a LFO that modulates the frequency of the notes
+ * around the note frequency. Updated every lfoMs
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param rate : LFO frequency, in 0.1Hz (e.g. 55 is 5.5Hz)
+ * @param depth : modulation depth, in per mille of the note frequency
+ * (e.g. 30 is +-3%). 0 disables the vibrato
+ * @param wave : LFO waveform
+ * @return buzzer_err_e
+ *
+ * @note only for Passive devices, set lfoMs and interruptMs before
+ */
+buzzer_err_e buzzer_set_vibrato(buzzer_t *buzzer, uint16_t rate, uint16_t depth, buzzer_lfo_wave_e wave);
+
+/**
+ * @brief Set the tremolo, a LFO that modulates the duty cycle (the
+ * volume) of the notes. Updated every lfoMs
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param rate : LFO frequency, in 0.1Hz
+ * @param depth : modulation depth, 255 goes down to silence. 0 disables
+ * the tremolo
+ * @param wave : LFO waveform
+ * @return buzzer_err_e
+ *
+ * @note only for Passive devices with fnx.pwmDutyOut, set lfoMs and
+ * interruptMs before
+ */
+buzzer_err_e buzzer_set_tremolo(buzzer_t *buzzer, uint16_t rate, uint8_t depth, buzzer_lfo_wave_e wave);
+#endif
+
+#if BUZZER_USE_SOFTPWM
+/**
+ * @brief Enable the soft PWM of an Active device. A fast timer calls
+ * buzzer_softpwm_interrupt(), that gates the GPIO with a bit pattern per
+ * volume level, and with a square wave on the note frequency, so Active
+ * devices also get distinguishable tones and volumes
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param hz : frequency that buzzer_softpwm_interrupt() is called,
+ * generally from 8kHz to 32kHz
+ * @return buzzer_err_e
+ *
+ * @note the freq parameters and pFreq arrays become relevant for Active
+ * devices, freq 0 keeps the native tone of the device
+ */
+buzzer_err_e buzzer_softpwm_init(buzzer_t *buzzer, uint32_t hz);
+
+/**
+ * @brief Set the volume of the soft PWM
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param level : from 0 (mute) to BUZZER_SOFTPWM_LEVELS - 1 (full)
+ */
+void buzzer_set_volume(buzzer_t *buzzer, uint8_t level);
+
+/**
+ * @brief call this function in the fast timer interrupt, with the hz
+ * of buzzer_softpwm_init(). The pin is only written when it changes
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ */
+void buzzer_softpwm_interrupt(buzzer_t *buzzer);
+#endif
+
+/**
+ * @brief Pause what is playing. The outputs are silenced and the whole
+ * state is kept, including the time left of the current note and of the
+ * effects. The instance leaves the active set, so buzzer_interrupt()
+ * returns at once and the idle callback can be called
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @return buzzer_err_e, BUZZER_ERR_PARAMS when nothing is playing
+ *
+ * @note buzzer_is_active() is BUZZER_IS_NOT_ACTIVE while paused. A start
+ * function or buzzer_stop() discards the paused play
+ */
+buzzer_err_e buzzer_pause(buzzer_t *buzzer);
+
+/**
+ * @brief Resume a play paused by buzzer_pause(), the outputs are written
+ * back and the current note ends after the time it had left
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @return buzzer_err_e, BUZZER_ERR_PARAMS when nothing is paused
+ */
+buzzer_err_e buzzer_resume(buzzer_t *buzzer);
+
+/**
+ * @brief Forget the last values written to the outputs, the next write of
+ * each one goes to the driver. Call it after the timer or the GPIO are
+ * reset or reconfigured outside of the library
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ */
+void buzzer_invalidate_output(buzzer_t *buzzer);
+
+/**
+ * @brief Return how many instances are playing, the idle callback is
+ * called when it falls to 0 and the wake callback when it leaves 0
+ *
+ * @return uint32_t
+ */
+uint32_t buzzer_get_active_count(void);
+
+/**
+ * @brief Return how many driver calls were suppressed since
+ * buzzer_init(), because the output already had the value
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @return uint32_t
+ */
+uint32_t buzzer_get_elided_writes(buzzer_t *buzzer);
+
 /**
  * Return if Buzzer is active
  */
@@ -232,5 +1067,26 @@ void buzzer_interrupt(buzzer_t *buzzer);
  */
 void buzzer_end_callback(buzzer_t *buzzer);
 
+/**
+ * @brief callback when the first instance starts to play, after all of
+ * them were silent. Called from the start function, before any output
+ * is written, restart here the buzzer_interrupt() timer and the PWM clocks
+ */
+void buzzer_wake_callback(void);
+
+/**
+ * @brief callback when the last playing instance ends or is stopped,
+ * can be called from buzzer_interrupt(). Stop here the buzzer_interrupt()
+ * timer and the PWM clocks, so the MCU can sleep
+ */
+void buzzer_idle_callback(void);
+
+/*
+ * Internals, shared with buzzer_multi.c and buzzer_pcm.c, so their plays
+ * also count for the idle and wake callbacks
+ */
+
+void __buzzer_acquire(void);
+void __buzzer_release(void);
 
 #endif /* APPLICATION_BUZZER_H_ */
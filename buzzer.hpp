@@ -0,0 +1,626 @@
+/**
+ * @file buzzer.hpp
+ * @author Pablo Jean Rozario (pablo.jean.eel@gmail.com)
+ * @brief Header-only C++17 layer of the buzzer library. Buzzer<> takes the
+ * driver and the tick as policy classes, and each start returns a move-only
+ * Session that stops the play when it is destroyed. Nothing is allocated
+ * on the heap, a Buzzer has the size of a buzzer_t plus a counter and a
+ * flag
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef APPLICATION_BUZZER_HPP_
+#define APPLICATION_BUZZER_HPP_
+
+extern "C" {
+#include "buzzer.h"
+}
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+ * Output policies
+ *
+ * An OutputPolicy is a class with static functions, that are called by the
+ * engine:
+ *
+ *  struct Tim3Pwm{
+ *      static void pwm(uint32_t freq);     // Passive devices, 0 turns off
+ *      static void duty(uint32_t duty);    // optional, envelope, tremolo
+ *  };
+ *  struct LedPin{
+ *      static void gpio(uint32_t val);     // Active devices
+ *  };
+ *
+ * A Clock is a class with the tick of buzzer_interrupt(), in ms:
+ *
+ *  struct Tim9Tick{
+ *      static constexpr uint16_t interruptMs = 1;
+ *  };
+ *
+ * By default the engine calls the policy through the fnx pointers, with a
+ * trampoline, so this build is not zero-overhead: each output is an indirect
+ * call, and the wrapper costs more cycles per tick than the C handle, most
+ * on the glides that write the timer on most ticks (see
+ * tools/buzzer_cpp_bench.cpp). To resolve the calls at compile time,
+ * bind the policy in one .cpp file with BUZZER_CPP_BIND_OUTPUTS(Policy),
+ * point the static outputs of the port header (see BUZZER_PORT_HEADER) to
+ * the bound functions and build with -flto, the driver is then inlined in
+ * buzzer_interrupt():
+ *
+ *  void buzzer_cpp_pwm_out(uint32_t freq);
+ *  #define BUZZER_PWM_OUT(freq)    buzzer_cpp_pwm_out(freq)
+ *
+ * The static outputs are shared by every instance, so all the Buzzer<> of
+ * such a build must use the bound policy.
+ */
+
+namespace buzzer{
+
+/**
+ * @brief Clock of a fixed tick, in ms
+ */
+template <uint16_t Ms>
+struct TickMs{
+    static_assert(Ms > 0, "the tick must be at least 1ms");
+    static constexpr uint16_t interruptMs = Ms;
+};
+
+namespace detail{
+
+template <class P, class = void>
+struct has_pwm : std::false_type{};
+template <class P>
+struct has_pwm<P, std::void_t<decltype(P::pwm(uint32_t{}))>> : std::true_type{};
+
+template <class P, class = void>
+struct has_duty : std::false_type{};
+template <class P>
+struct has_duty<P, std::void_t<decltype(P::duty(uint32_t{}))>> : std::true_type{};
+
+template <class P, class = void>
+struct has_gpio : std::false_type{};
+template <class P>
+struct has_gpio<P, std::void_t<decltype(P::gpio(uint32_t{}))>> : std::true_type{};
+
+template <class P>
+inline void pwm_out(uint32_t freq){
+    if constexpr (has_pwm<P>::value)
+        P::pwm(freq);
+}
+
+template <class P>
+inline void duty_out(uint32_t duty){
+    if constexpr (has_duty<P>::value)
+        P::duty(duty);
+}
+
+template <class P>
+inline void gpio_out(uint32_t val){
+    if constexpr (has_gpio<P>::value)
+        P::gpio(val);
+}
+
+}  // namespace detail
+
+#if BUZZER_USE_PACKED
+/**
+ * @brief A melody in the packed format of buzzer_start_packed(), built at
+ * compile time by BUZZER_MELODY() or the _melody literal
+ */
+template <std::size_t N>
+struct PackedMelody{
+    uint8_t data[N];
+
+    constexpr std::size_t size() const noexcept{
+        return N;
+    }
+
+    constexpr uint16_t notes() const noexcept{
+        return static_cast<uint16_t>(data[2] | (data[3] << 8));
+    }
+};
+
+namespace detail{
+
+/*
+ * Not constexpr, a malformed tune calls one of them while it is parsed by
+ * the compiler, that stops with its name in the error
+ */
+inline void melody_error_bad_token(){}
+inline void melody_error_pitch_out_of_range(){}
+inline void melody_error_bad_duration(){}
+inline void melody_error_bad_tempo(){}
+inline void melody_error_too_long(){}
+
+constexpr bool melody_is_digit(char c){
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool melody_is_end(char c){
+    return c == '\0' || c == ' ' || c == '\t' || c == '\n' || c == '|';
+}
+
+constexpr uint32_t melody_number(const char *s, std::size_t &i){
+    uint32_t n = 0;
+
+    if (!melody_is_digit(s[i]))
+        melody_error_bad_token();
+    while (melody_is_digit(s[i]) && n < 0x10000)
+        n = n * 10 + static_cast<uint32_t>(s[i++] - '0');
+    return n;
+}
+
+/**
+ * @brief parses a tune, writes the packed form on out (when not null) and
+ * returns its size. Tokens are separated by spaces (or '|', for the
+ * bars):
+ *
+ *  T<bpm>              tempo, in quarters per minute, only as the first
+ *                      token, 120 when missing
+ *  <pitch>[:<div>[.]]  a note, E7, C#5, Bb3 (NOTE_B0 to NOTE_DS8), or R
+ *                      for a rest. div is the note value, 8 is an eighth,
+ *                      '.' dots it. Without it, the previous value is kept
+ */
+constexpr std::size_t melody_parse(const char *s, uint8_t *out){
+    constexpr int8_t semitone[7] = {9, 11, 0, 2, 4, 5, 7};    // A to G
+    std::size_t i = 0, n = BUZZER_PACKED_HEADER_LEN;
+    uint32_t bpm = 120, notes = 0, whole = 0;
+    uint8_t dur = 4;
+
+    while (s[i] == ' ' || s[i] == '\t' || s[i] == '\n')
+        i++;
+    if (s[i] == 'T'){
+        i++;
+        bpm = melody_number(s, i);
+        if (bpm < 4 || bpm > 60000 || !melody_is_end(s[i]))
+            melody_error_bad_tempo();
+    }
+    whole = 240000 / bpm;
+
+    for (;;){
+        int32_t pitch = 0;
+        uint8_t d = dur;
+
+        while (s[i] != '\0' && melody_is_end(s[i]))
+            i++;
+        if (s[i] == '\0')
+            break;
+
+        if (s[i] == 'R'){
+            i++;
+        }
+        else if (s[i] >= 'A' && s[i] <= 'G'){
+            pitch = semitone[s[i++] - 'A'];
+            if (s[i] == '#')
+                pitch++, i++;
+            else if (s[i] == 'b')
+                pitch--, i++;
+            if (!melody_is_digit(s[i]))
+                melody_error_bad_token();
+            // semitones from NOTE_B0, that is 1
+            pitch += (s[i++] - '0') * 12 - 10;
+            if (pitch < 1 || pitch >= BUZZER_PACKED_PITCHES)
+                melody_error_pitch_out_of_range();
+        }
+        else{
+            melody_error_bad_token();
+        }
+
+        if (s[i] == ':'){
+            uint32_t div = 0;
+
+            i++;
+            div = melody_number(s, i);
+            if (div == 0 || div > BUZZER_PACKED_DIV_MASK)
+                melody_error_bad_duration();
+            d = static_cast<uint8_t>(div);
+            if (s[i] == '.'){
+                d |= BUZZER_PACKED_DOT_FLAG;
+                i++;
+            }
+        }
+        if (!melody_is_end(s[i]))
+            melody_error_bad_token();
+
+        if (out != nullptr)
+            out[n] = static_cast<uint8_t>(pitch | (d != dur ? BUZZER_PACKED_DUR_FLAG : 0));
+        n++;
+        if (d != dur){
+            if (out != nullptr)
+                out[n] = d;
+            n++;
+            dur = d;
+        }
+        if (++notes > 0xFFFF)
+            melody_error_too_long();
+    }
+
+    if (out != nullptr){
+        out[0] = static_cast<uint8_t>(whole);
+        out[1] = static_cast<uint8_t>(whole >> 8);
+        out[2] = static_cast<uint8_t>(notes);
+        out[3] = static_cast<uint8_t>(notes >> 8);
+    }
+    return n;
+}
+
+template <std::size_t N>
+constexpr PackedMelody<N> melody_pack(const char *s){
+    PackedMelody<N> m{};
+
+    melody_parse(s, m.data);
+    return m;
+}
+
+#if __cplusplus >= 202002L
+template <std::size_t N>
+struct melody_string{
+    char s[N];
+
+    constexpr melody_string(const char (&str)[N]){
+        for (std::size_t i = 0 ; i < N ; i++)
+            s[i] = str[i];
+    }
+};
+#endif
+
+}  // namespace detail
+
+#if __cplusplus >= 202002L
+namespace literals{
+
+/**
+ * @brief C++20, "T250 E7:8 E7 R E7"_melody, see BUZZER_MELODY()
+ */
+template <detail::melody_string S>
+consteval auto operator""_melody(){
+    return detail::melody_pack<detail::melody_parse(S.s, nullptr)>(S.s);
+}
+
+}  // namespace literals
+#endif
+#endif
+
+template <class OutputPolicy, class Clock>
+class Buzzer;
+
+/**
+ * @brief A playback started by a Buzzer. Move-only, the play is stopped
+ * when the owning Session is destroyed or assigned, unless release() was
+ * called. A Session of a play that already ended, or that was replaced by
+ * a newer start, does nothing
+ */
+template <class B>
+class [[nodiscard]] Session{
+public:
+    Session() noexcept = default;
+
+    Session(Session &&other) noexcept
+        : owner_(other.owner_), gen_(other.gen_){
+        other.owner_ = nullptr;
+    }
+
+    Session &operator=(Session &&other) noexcept{
+        if (this != &other){
+            stop();
+            owner_ = other.owner_;
+            gen_ = other.gen_;
+            other.owner_ = nullptr;
+        }
+        return *this;
+    }
+
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
+
+    ~Session(){
+        stop();
+    }
+
+    /**
+     * @brief true until the play of this session ends, is stopped or is
+     * replaced by a newer start, also while it is paused
+     */
+    bool playing() const noexcept{
+        return owner_ != nullptr && owner_->generation() == gen_ &&
+                (owner_->active() || owner_->paused());
+    }
+
+    /**
+     * @brief true while the play of this session is paused
+     */
+    bool paused() const noexcept{
+        return owner_ != nullptr && owner_->generation() == gen_ &&
+                owner_->paused();
+    }
+
+    /**
+     * @brief stop the play now, if it is still the one of this session,
+     * a paused one can't be resumed anymore
+     */
+    void stop() noexcept{
+        if (playing())
+            owner_->stop();
+        owner_ = nullptr;
+    }
+
+    /**
+     * @brief detach the session, the play continues until its end
+     */
+    void release() noexcept{
+        owner_ = nullptr;
+    }
+
+private:
+    friend B;
+
+    Session(B *owner, uint32_t gen) noexcept
+        : owner_(owner), gen_(gen){}
+
+    B *owner_ = nullptr;
+    uint32_t gen_ = 0;
+};
+
+/**
+ * @brief A buzzer driven by OutputPolicy, ticked every Clock::interruptMs
+ * by tick(). Not copyable nor movable, the timer interrupt and the
+ * sessions keep its address. The constructor doesn't call the driver, so
+ * a global Buzzer is safe before the clocks and the pins are set up; the
+ * driver is initialized by init(), or by the first start
+ */
+template <class OutputPolicy, class Clock>
+class Buzzer{
+    static constexpr bool kPwm = detail::has_pwm<OutputPolicy>::value;
+    static constexpr bool kDuty = detail::has_duty<OutputPolicy>::value;
+    static constexpr bool kGpio = detail::has_gpio<OutputPolicy>::value;
+
+    static_assert(kPwm != kGpio,
+            "the OutputPolicy must have one of pwm() or gpio()");
+    static_assert(!kDuty || kPwm, "duty() is only used with pwm()");
+    static_assert(BUZZER_STATIC_TYPE != BUZZER_STATIC_PASSIVE || kPwm,
+            "the engine is built for Passive devices only");
+    static_assert(BUZZER_STATIC_TYPE != BUZZER_STATIC_ACTIVE || kGpio,
+            "the engine is built for Active devices only");
+    static_assert(BUZZER_STATIC_INTERRUPT_MS == 0 ||
+            BUZZER_STATIC_INTERRUPT_MS == Clock::interruptMs,
+            "the Clock differs from BUZZER_STATIC_INTERRUPT_MS");
+
+public:
+    using session_type = Session<Buzzer>;
+
+    Buzzer() noexcept{
+        if constexpr (kPwm)
+            handle_.fnx.pwmOut = detail::pwm_out<OutputPolicy>;
+        if constexpr (kDuty)
+            handle_.fnx.pwmDutyOut = detail::duty_out<OutputPolicy>;
+        if constexpr (kGpio)
+            handle_.fnx.gpioOut = detail::gpio_out<OutputPolicy>;
+        handle_.interruptMs = Clock::interruptMs;
+    }
+
+    Buzzer(const Buzzer &) = delete;
+    Buzzer &operator=(const Buzzer &) = delete;
+
+    ~Buzzer(){
+        stop();
+    }
+
+    /**
+     * @brief initialize the engine and turn the output off, see
+     * buzzer_init(). Optional, the first start calls it, use it to set
+     * the pin at boot or to reset the effects
+     */
+    buzzer_err_e init() noexcept{
+        ready_ = true;
+        return buzzer_init(&handle_);
+    }
+
+    /**
+     * @brief call it every Clock::interruptMs, see buzzer_interrupt()
+     */
+    void tick() noexcept{
+        buzzer_interrupt(&handle_);
+    }
+
+    session_type turn_on(uint16_t freq) noexcept{
+        buzzer_turn_on(handle(), freq);
+        return next_session();
+    }
+
+    session_type start(uint16_t freq, uint16_t period,
+            buzzer_loop_e loop = BUZZER_LOOP_OFF) noexcept{
+        buzzer_start(handle(), freq, period, loop);
+        return next_session();
+    }
+
+    session_type start_array(uint16_t *pPeriod, uint16_t *pFreq,
+            uint16_t len) noexcept{
+        buzzer_start_array(handle(), pPeriod, pFreq, len);
+        return next_session();
+    }
+
+    /**
+     * @brief like start_array(), the arrays must have the same length
+     */
+    template <std::size_t N>
+    session_type start_array(uint16_t (&period)[N],
+            uint16_t (&freq)[N]) noexcept{
+        static_assert(N > 0 && N <= UINT16_MAX, "invalid melody length");
+        return start_array(period, freq, static_cast<uint16_t>(N));
+    }
+
+    session_type start_melody(const buzzer_melody_t &melody) noexcept{
+        buzzer_start_melody(handle(), &melody);
+        return next_session();
+    }
+
+#if BUZZER_USE_CHORDS
+    session_type start_chord_array(uint16_t *pPeriod,
+            buzzer_chord_t *pChord, uint16_t len) noexcept{
+        buzzer_start_chord_array(handle(), pPeriod, pChord, len);
+        return next_session();
+    }
+
+    template <std::size_t N>
+    session_type start_chord_array(uint16_t (&period)[N],
+            buzzer_chord_t (&chord)[N]) noexcept{
+        static_assert(N > 0 && N <= UINT16_MAX, "invalid melody length");
+        return start_chord_array(period, chord, static_cast<uint16_t>(N));
+    }
+#endif
+
+#if BUZZER_USE_SFX
+    session_type start_sfx(const buzzer_sfx_t &sfx) noexcept{
+        buzzer_start_sfx(handle(), &sfx);
+        return next_session();
+    }
+#endif
+
+#if BUZZER_USE_PACKED
+    template <std::size_t N>
+    session_type start_packed(const PackedMelody<N> &melody) noexcept{
+        buzzer_start_packed(handle(), melody.data);
+        return next_session();
+    }
+#endif
+
+#if BUZZER_USE_PATTERN
+    session_type start_pattern(const buzzer_pattern_t &pattern) noexcept{
+        buzzer_start_pattern(handle(), &pattern);
+        return next_session();
+    }
+#endif
+
+#if BUZZER_USE_BURST
+    session_type start_burst(const buzzer_burst_t &burst) noexcept{
+        buzzer_start_burst(handle(), &burst);
+        return next_session();
+    }
+#endif
+
+#if BUZZER_USE_MORSE
+    session_type start_morse(const buzzer_morse_t &morse) noexcept{
+        buzzer_start_morse(handle(), &morse);
+        return next_session();
+    }
+#endif
+
+#if BUZZER_USE_ENVELOPE
+    buzzer_err_e set_envelope(const buzzer_envelope_t *envelope) noexcept{
+        return buzzer_set_envelope(handle(), envelope);
+    }
+#endif
+
+    /**
+     * @brief stop any play, the sessions of it become empty
+     */
+    void stop() noexcept{
+        if (ready_)
+            buzzer_stop(&handle_);
+    }
+
+    bool active() const noexcept{
+        return handle_.active == BUZZER_IS_ACTIVE;
+    }
+
+    /**
+     * @brief true while a play is paused, see pause()
+     */
+    bool paused() const noexcept{
+        return handle_.paused.state != BUZZER_STATE_IDLE;
+    }
+
+    buzzer_err_e pause() noexcept{
+        return buzzer_pause(&handle_);
+    }
+
+    buzzer_err_e resume() noexcept{
+        return buzzer_resume(&handle_);
+    }
+
+#if BUZZER_USE_SEEK
+    uint32_t position_ms() noexcept{
+        return buzzer_get_position_ms(&handle_);
+    }
+
+    uint32_t duration_ms() noexcept{
+        return buzzer_get_duration_ms(&handle_);
+    }
+
+    buzzer_err_e seek_ms(uint32_t ms) noexcept{
+        return buzzer_seek_ms(&handle_, ms);
+    }
+#endif
+
+    /**
+     * @brief incremented on every start, identifies the current play
+     */
+    uint32_t generation() const noexcept{
+        return gen_;
+    }
+
+    /**
+     * @brief the C handle, initialized, for the APIs without a wrapper.
+     * Plays started with it aren't owned by any session
+     */
+    buzzer_t *c_handle() noexcept{
+        return handle();
+    }
+
+private:
+    buzzer_t *handle() noexcept{
+        if (!ready_)
+            init();
+        return &handle_;
+    }
+
+    session_type next_session() noexcept{
+        return session_type(this, ++gen_);
+    }
+
+    buzzer_t handle_{};
+    uint32_t gen_ = 0;
+    bool ready_ = false;
+};
+
+}  // namespace buzzer
+
+/**
+ * @brief defines the functions of the static outputs, bound to Policy. Use
+ * it once, in a .cpp file, see the Output policies above
+ */
+#define BUZZER_CPP_BIND_OUTPUTS(Policy) \
+    extern "C" void buzzer_cpp_pwm_out(uint32_t freq){ \
+        ::buzzer::detail::pwm_out<Policy>(freq); \
+    } \
+    extern "C" void buzzer_cpp_duty_out(uint32_t duty){ \
+        ::buzzer::detail::duty_out<Policy>(duty); \
+    } \
+    extern "C" void buzzer_cpp_gpio_out(uint32_t val){ \
+        ::buzzer::detail::gpio_out<Policy>(val); \
+    }
+
+#if BUZZER_USE_PACKED
+/**
+ * @brief packs a tune at compile time, a malformed tune or a pitch out of
+ * notes.h is a compile error. The tune syntax is on melody_parse(), e.g.
+ *
+ *  static constexpr auto tune = BUZZER_MELODY("T250 E7:8 E7 R E7 R C7 E7 R G7");
+ *  buzzer_start_packed(&buzzer, tune.data);
+ */
+#define BUZZER_MELODY(tune) \
+    ([]{ \
+        constexpr auto _m = ::buzzer::detail::melody_pack< \
+                ::buzzer::detail::melody_parse(tune, nullptr)>(tune); \
+        return _m; \
+    }())
+#endif
+
+#endif /* APPLICATION_BUZZER_HPP_ */
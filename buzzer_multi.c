@@ -0,0 +1,142 @@
+/*
+ * buzzer_multi.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ */
+
+#include "buzzer_multi.h"
+
+/**
+ * privates
+ */
+
+#if BUZZER_USE_TRACE
+static uint8_t _traceIds = 0x80;
+#endif
+
+// aux functions
+
+static void __buzzer_multi_off(buzzer_multi_t *buzzer){
+    uint32_t changed = 0;
+    uint8_t v;
+
+    for (v = 0 ; v < buzzer->voices ; v++){
+        if (buzzer->freq[v] != 0){
+            changed |= 1UL << v;
+        }
+        buzzer->freq[v] = 0;
+    }
+    buzzer->fnx.pwmOut(buzzer->freq, changed);
+}
+
+static void __buzzer_multi_load(buzzer_multi_t *buzzer, uint_fast16_t i){
+    uint16_t *pFreq = &buzzer->play_param.pFreq[i * buzzer->voices];
+    uint32_t changed = 0;
+    uint8_t v;
+
+    for (v = 0 ; v < buzzer->voices ; v++){
+        if (buzzer->freq[v] != pFreq[v]){
+            changed |= 1UL << v;
+            buzzer->freq[v] = pFreq[v];
+        }
+    }
+    buzzer->play_param.time = buzzer->play_param.pTimes[i];
+    buzzer->fnx.pwmOut(buzzer->freq, changed);
+    BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_NOTE, pFreq[0]);
+}
+
+/*
+ * Publics
+ */
+
+// callback
+
+void __attribute__((weak)) buzzer_multi_end_callback(buzzer_multi_t *buzzer){
+
+}
+
+// interrupts
+
+void buzzer_multi_interrupt(buzzer_multi_t *buzzer){
+    buzzer->counting += buzzer->interruptMs;
+    if (buzzer->active &&
+            buzzer->counting > buzzer->play_param.time){
+        buzzer->counting = 0;
+        buzzer->play_param.i++;
+        if (buzzer->play_param.i < buzzer->play_param.len){
+            __buzzer_multi_load(buzzer, buzzer->play_param.i);
+        }
+        else{
+            __buzzer_multi_off(buzzer);
+            BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_STOP, 0);
+            BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_CALLBACK, 0);
+            // cleared before the callback, that can start another play.
+            // Released after it, so a new play doesn't trigger an idle
+            // and a wake
+            buzzer->active = BUZZER_IS_NOT_ACTIVE;
+            buzzer_multi_end_callback(buzzer);
+            __buzzer_release();
+        }
+    }
+}
+
+buzzer_err_e buzzer_multi_init(buzzer_multi_t *buzzer){
+    if (buzzer != NULL && buzzer->fnx.pwmOut != NULL &&
+            buzzer->voices > 0 && buzzer->voices <= BUZZER_MULTI_VOICES){
+#if BUZZER_USE_TRACE
+        buzzer->traceId = _traceIds++;
+#endif
+        // a play that is running leaves the active set
+        if (buzzer->active == BUZZER_IS_ACTIVE){
+            __buzzer_release();
+        }
+        buzzer->active = BUZZER_IS_NOT_ACTIVE;
+        memset(buzzer->freq, 0, sizeof(buzzer->freq));
+        buzzer->fnx.pwmOut(buzzer->freq, (1UL << buzzer->voices) - 1);
+
+        return BUZZER_ERR_OK;
+    }
+
+    return BUZZER_ERR_PARAMS;
+}
+
+void buzzer_multi_stop(buzzer_multi_t *buzzer){
+    if (buzzer != NULL){
+        BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_STOP, 0);
+        __buzzer_multi_off(buzzer);
+        if (buzzer->active == BUZZER_IS_ACTIVE){
+            buzzer->active = BUZZER_IS_NOT_ACTIVE;
+            __buzzer_release();
+        }
+    }
+}
+
+void buzzer_multi_start_array(buzzer_multi_t *buzzer, uint16_t *pPeriod, uint16_t *pFreq, uint16_t len){
+    if (buzzer != NULL && pPeriod != NULL && pFreq != NULL && len > 0){
+#if BUZZER_USE_TRACE
+        if (buzzer->active){
+            BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_PREEMPT, buzzer->freq[0]);
+        }
+        BUZZER_TRACE(buzzer, BUZZER_TRACE_EV_START, pFreq[0]);
+#endif
+        buzzer->play_param.pTimes = pPeriod;
+        buzzer->play_param.pFreq = pFreq;
+        buzzer->play_param.len = len;
+        buzzer->play_param.i = 0;
+        buzzer->counting = 0;
+        // the wake callback before any output is written
+        if (buzzer->active == BUZZER_IS_NOT_ACTIVE){
+            buzzer->active = BUZZER_IS_ACTIVE;
+            __buzzer_acquire();
+        }
+        __buzzer_multi_load(buzzer, 0);
+    }
+}
+
+buzzer_active_e buzzer_multi_is_active(buzzer_multi_t *buzzer){
+    if (buzzer != NULL){
+        return buzzer->active;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file buzzer_multi.h
+ * @author Pablo Jean Rozario (pablo.jean.eel@gmail.com)
+ * @brief Multi voice buzzer, plays a polyphonic array on several PWM
+ * channels (e.g. the four channels of a timer) with a single scheduler.
+ * Each note edge calls the output function once, with the frequencies
+ * of all the voices
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BUZZER_MULTI_H_
+#define BUZZER_MULTI_H_
+
+#include "buzzer.h"
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief max number of voices of a buzzer_multi_t
+ */
+#ifndef BUZZER_MULTI_VOICES
+#define BUZZER_MULTI_VOICES		4
+#endif
+
+/*
+ * Functions typedefs
+ */
+
+/**
+ * @brief Function pointer to set the frequency of all the voices at once.
+ * freq has one value per voice, 0 must turnoff that channel. changed
+ * has a bit set for each voice that changed since the last call, the
+ * other channels can be left untouched
+ */
+typedef void (*multiPwmOutFx)(const uint32_t *freq, uint32_t changed);
+
+/*
+ * Structs and Unions
+ */
+
+typedef struct{
+    // user must define these parameters
+    struct{
+        /**
+         * @brief Function to handle with the PWM frequency of all
+         * the voices. Write all the channels before returning, so
+         * the edge is the same for every voice
+         */
+        multiPwmOutFx pwmOut;
+    }fnx;
+
+    // number of voices (channels), from 1 to BUZZER_MULTI_VOICES
+    uint8_t voices;
+    // the interrupt period that you will call buzzer_multi_interrupt()
+    uint_fast16_t interruptMs;
+
+    // internal library variables, no need to work with these
+#if BUZZER_USE_TRACE
+    uint8_t traceId;
+#endif
+    buzzer_active_e active;
+    uint_fast16_t counting;
+    uint32_t freq[BUZZER_MULTI_VOICES];
+    struct{
+        uint16_t *pTimes;
+        uint16_t *pFreq;
+        uint_fast16_t i;
+        uint_fast16_t len;
+
+        int_fast32_t time;
+    }play_param;
+}buzzer_multi_t;
+
+/*
+ * Functions Prototypes
+ */
+
+/**
+ * @brief Initialize the multi voice buzzer, and turnoff all voices
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @return buzzer_err_e
+ */
+buzzer_err_e buzzer_multi_init(buzzer_multi_t *buzzer);
+
+/**
+ * @brief Turnoff all the voices imediatly
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ */
+void buzzer_multi_stop(buzzer_multi_t *buzzer);
+
+/**
+ * @brief Start to play a polyphonic array. pFreq has one row per note
+ * event, with one frequency per voice (0 is silence), so it has
+ * len * voices values
+ * buzzer_multi_interrupt must be working
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @param pPeriod : array of period, with len values
+ * @param pFreq : array of frequencies, with len * voices values
+ * @param len : number of note events
+ */
+void buzzer_multi_start_array(buzzer_multi_t *buzzer, uint16_t *pPeriod, uint16_t *pFreq, uint16_t len);
+
+/**
+ * @brief Return if the multi voice buzzer is active
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ * @return buzzer_active_e
+ */
+buzzer_active_e buzzer_multi_is_active(buzzer_multi_t *buzzer);
+
+/**
+ * @brief call this function in a periodic timing, the period of
+ * interrupt is configured on buzzer_multi_t structure
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ */
+void buzzer_multi_interrupt(buzzer_multi_t *buzzer);
+
+/**
+ * @brief callback when an array has your execution finished
+ *
+ * @param buzzer : pointer to the handle of the buzzer
+ */
+void buzzer_multi_end_callback(buzzer_multi_t *buzzer);
+
+#endif /* BUZZER_MULTI_H_ */
@@ -0,0 +1,147 @@
+/*
+ * buzzer_pcm.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ */
+
+#include "buzzer_pcm.h"
+
+/**
+ * privates
+ */
+
+// aux functions
+
+static uint32_t __buzzer_pcm_array_source(uint8_t *dst, uint32_t len, void *ctx){
+    buzzer_pcm_t *pcm = (buzzer_pcm_t*)ctx;
+
+    if (len > pcm->array.len){
+        len = pcm->array.len;
+    }
+    memcpy(dst, pcm->array.pSamples, len);
+    pcm->array.pSamples += len;
+    pcm->array.len -= len;
+
+    return len;
+}
+
+static void __buzzer_pcm_fill(buzzer_pcm_t *pcm, uint8_t *dst){
+    uint32_t half = pcm->bufLen / 2;
+    uint32_t n = 0;
+
+    if (pcm->drain == 0){
+        n = pcm->source(dst, half, pcm->ctx);
+        if (n < half){
+            // the last samples end after two more transfer interrupts
+            pcm->drain = 2;
+        }
+    }
+    if (n < half){
+        memset(&dst[n], BUZZER_PCM_SILENCE, half - n);
+    }
+}
+
+static void __buzzer_pcm_refill(buzzer_pcm_t *pcm, uint8_t *dst){
+    if (!pcm->active){
+        return;
+    }
+    if (pcm->drain > 0 && --pcm->drain == 0){
+        // as buzzer_pcm_stop(), but released after the callback, that
+        // can start another play
+        pcm->active = BUZZER_IS_NOT_ACTIVE;
+        pcm->fnx.stop();
+        buzzer_pcm_end_callback(pcm);
+        __buzzer_release();
+        return;
+    }
+    __buzzer_pcm_fill(pcm, dst);
+}
+
+/*
+ * Publics
+ */
+
+// callback
+
+void __attribute__((weak)) buzzer_pcm_end_callback(buzzer_pcm_t *pcm){
+
+}
+
+// interrupts
+
+void buzzer_pcm_half_transfer(buzzer_pcm_t *pcm){
+    __buzzer_pcm_refill(pcm, pcm->buf);
+}
+
+void buzzer_pcm_transfer_complete(buzzer_pcm_t *pcm){
+    __buzzer_pcm_refill(pcm, &pcm->buf[pcm->bufLen / 2]);
+}
+
+buzzer_err_e buzzer_pcm_init(buzzer_pcm_t *pcm){
+    if (pcm != NULL && pcm->fnx.start != NULL && pcm->fnx.stop != NULL &&
+            pcm->buf != NULL && pcm->bufLen >= 2 && (pcm->bufLen & 1) == 0){
+        // a play that is running leaves the active set
+        if (pcm->active == BUZZER_IS_ACTIVE){
+            __buzzer_release();
+        }
+        pcm->active = BUZZER_IS_NOT_ACTIVE;
+        pcm->fnx.stop();
+
+        return BUZZER_ERR_OK;
+    }
+
+    return BUZZER_ERR_PARAMS;
+}
+
+buzzer_err_e buzzer_pcm_play(buzzer_pcm_t *pcm, pcmSourceFx source, void *ctx, uint32_t sampleRate){
+    if (pcm == NULL || source == NULL || sampleRate == 0){
+        return BUZZER_ERR_PARAMS;
+    }
+    if (pcm->active){
+        // the DMA only, the play stays acquired
+        pcm->fnx.stop();
+    }
+    pcm->source = source;
+    pcm->ctx = ctx;
+    pcm->drain = 0;
+    __buzzer_pcm_fill(pcm, pcm->buf);
+    __buzzer_pcm_fill(pcm, &pcm->buf[pcm->bufLen / 2]);
+    if (pcm->active == BUZZER_IS_NOT_ACTIVE){
+        pcm->active = BUZZER_IS_ACTIVE;
+        __buzzer_acquire();
+    }
+    pcm->fnx.start(pcm->buf, pcm->bufLen, sampleRate);
+
+    return BUZZER_ERR_OK;
+}
+
+buzzer_err_e buzzer_pcm_play_array(buzzer_pcm_t *pcm, const uint8_t *pSamples, uint32_t len, uint32_t sampleRate){
+    if (pcm == NULL || pSamples == NULL){
+        return BUZZER_ERR_PARAMS;
+    }
+    if (pcm->active){
+        pcm->fnx.stop();
+    }
+    pcm->array.pSamples = pSamples;
+    pcm->array.len = len;
+
+    return buzzer_pcm_play(pcm, __buzzer_pcm_array_source, pcm, sampleRate);
+}
+
+void buzzer_pcm_stop(buzzer_pcm_t *pcm){
+    if (pcm != NULL){
+        pcm->fnx.stop();
+        if (pcm->active == BUZZER_IS_ACTIVE){
+            pcm->active = BUZZER_IS_NOT_ACTIVE;
+            __buzzer_release();
+        }
+    }
+}
+
+buzzer_active_e buzzer_pcm_is_active(buzzer_pcm_t *pcm){
+    if (pcm != NULL){
+        return pcm->active;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file buzzer_pcm.h
+ * @author Pablo Jean Rozario (pablo.jean.eel@gmail.com)
+ * @brief PCM playback on a Passive buzzer. 8 bits unsigned samples are
+ * written by a circular DMA into the compare register of a PWM with a
+ * fixed, ultrasonic, carrier (e.g. 62.5kHz with ARR = 255). The library
+ * refills each half of the double buffer, from a source function, on
+ * the half and full transfer interrupts
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BUZZER_PCM_H_
+#define BUZZER_PCM_H_
+
+#include "buzzer.h"
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief value of a silent sample
+ */
+#define BUZZER_PCM_SILENCE		0x80
+
+/*
+ * Functions typedefs
+ */
+
+/**
+ * @brief Function that fills dst with up to len samples. Returning less
+ * than len means the end of the sound
+ */
+typedef uint32_t (*pcmSourceFx)(uint8_t *dst, uint32_t len, void *ctx);
+/**
+ * @brief Function that starts the PWM carrier and the circular DMA over
+ * buf, with one transfer per sample at sampleRate, and the half and full
+ * transfer interrupts enabled
+ */
+typedef void (*pcmStartFx)(uint8_t *buf, uint32_t len, uint32_t sampleRate);
+/**
+ * @brief Function that stops the DMA and turnoff the PWM output
+ */
+typedef void (*pcmStopFx)(void);
+
+/*
+ * Structs and Unions
+ */
+
+typedef struct{
+    // user must define these parameters
+    struct{
+        pcmStartFx start;
+        pcmStopFx stop;
+    }fnx;
+
+    // double buffer, used by the DMA, bufLen must be even. Each half
+    // is refilled in one interrupt, bufLen/2 samples at a time
+    uint8_t *buf;
+    uint16_t bufLen;
+
+    // internal library variables, no need to work with these
+    buzzer_active_e active;
+    uint8_t drain;
+    pcmSourceFx source;
+    void *ctx;
+    struct{
+        const uint8_t *pSamples;
+        uint32_t len;
+    }array;
+}buzzer_pcm_t;
+
+/*
+ * Functions Prototypes
+ */
+
+/**
+ * @brief Initialize the PCM player
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ * @return buzzer_err_e
+ */
+buzzer_err_e buzzer_pcm_init(buzzer_pcm_t *pcm);
+
+/**
+ * @brief Start to play samples from a source function
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ * @param source : function that provides the samples
+ * @param ctx : argument of source
+ * @param sampleRate : sample rate, in Hz, generally from 8000 to 22050
+ * @return buzzer_err_e
+ */
+buzzer_err_e buzzer_pcm_play(buzzer_pcm_t *pcm, pcmSourceFx source, void *ctx, uint32_t sampleRate);
+
+/**
+ * @brief Start to play an array of samples, generally from flash
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ * @param pSamples : 8 bits unsigned samples
+ * @param len : number of samples
+ * @param sampleRate : sample rate, in Hz
+ * @return buzzer_err_e
+ */
+buzzer_err_e buzzer_pcm_play_array(buzzer_pcm_t *pcm, const uint8_t *pSamples, uint32_t len, uint32_t sampleRate);
+
+/**
+ * @brief Stop the playback imediatly
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ */
+void buzzer_pcm_stop(buzzer_pcm_t *pcm);
+
+/**
+ * @brief Return if the PCM player is active
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ * @return buzzer_active_e
+ */
+buzzer_active_e buzzer_pcm_is_active(buzzer_pcm_t *pcm);
+
+/**
+ * @brief call this function on the DMA half transfer interrupt
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ */
+void buzzer_pcm_half_transfer(buzzer_pcm_t *pcm);
+
+/**
+ * @brief call this function on the DMA transfer complete interrupt
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ */
+void buzzer_pcm_transfer_complete(buzzer_pcm_t *pcm);
+
+/**
+ * @brief callback when the sound has your execution finished
+ *
+ * @param pcm : pointer to the handle of the PCM player
+ */
+void buzzer_pcm_end_callback(buzzer_pcm_t *pcm);
+
+#endif /* BUZZER_PCM_H_ */
@@ -0,0 +1,36 @@
+/*
+ * buzzer_trace.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ */
+
+#include "buzzer.h"
+
+#if BUZZER_USE_TRACE
+
+#if (BUZZER_TRACE_LEN & (BUZZER_TRACE_LEN - 1)) != 0
+#error "BUZZER_TRACE_LEN must be a power of 2"
+#endif
+
+/*
+ * Publics
+ */
+
+buzzer_trace_buf_t buzzer_trace = {
+    .magic = BUZZER_TRACE_MAGIC,
+    .len = BUZZER_TRACE_LEN,
+    .recSize = sizeof(buzzer_trace_rec_t),
+    .head = 0
+};
+
+uint32_t __attribute__((weak)) buzzer_trace_timestamp(void){
+    return 0;
+}
+
+void buzzer_trace_clear(void){
+    buzzer_trace.head = 0;
+    memset(buzzer_trace.rec, 0, sizeof(buzzer_trace.rec));
+}
+
+#endif /* BUZZER_USE_TRACE */
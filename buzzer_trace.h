@@ -0,0 +1,147 @@
+/**
+ * @file buzzer_trace.h
+ * @author Pablo Jean Rozario (pablo.jean.eel@gmail.com)
+ * @brief Optional event trace of the buzzer engine. Every note edge,
+ * start, stop, preemption and callback is stored as a fixed size record
+ * in a ring buffer in RAM, that can be dumped with the debugger and
+ * decoded on the host with tools/buzzer_trace_decode.c
+ * @version 1.0
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#ifndef BUZZER_TRACE_H_
+#define BUZZER_TRACE_H_
+
+#include <stdint.h>
+
+/*
+ * Macros
+ */
+
+/**
+ * @brief number of records of the ring buffer, MUST be a power of 2
+ */
+#ifndef BUZZER_TRACE_LEN
+#define BUZZER_TRACE_LEN		64
+#endif
+
+/**
+ * @brief "BZTR", used by the decoder to find the buffer in a RAM dump
+ */
+#define BUZZER_TRACE_MAGIC		0x52545A42UL
+
+/**
+ * @brief timestamp source of the records. By default it calls
+ * buzzer_trace_timestamp(), that is weak and can be overridden. For the
+ * lowest overhead define this macro with a free running counter,
+ * e.g. -DBUZZER_TRACE_TIMESTAMP()=DWT->CYCCNT
+ */
+#ifndef BUZZER_TRACE_TIMESTAMP
+#define BUZZER_TRACE_TIMESTAMP()	buzzer_trace_timestamp()
+#endif
+
+/*
+ * Enumerates
+ */
+
+/**
+ * @brief the traced events
+ *
+ * BUZZER_TRACE_EV_START : a start API was called, freq is the first freq
+ * BUZZER_TRACE_EV_STOP : the output was stopped by buzzer_stop() or
+ *                        at the end of a play
+ * BUZZER_TRACE_EV_NOTE : note edge, freq is the new output (0 is silence)
+ * BUZZER_TRACE_EV_PREEMPT : a start API was called while the buzzer was
+ *                           active, freq is the interrupted freq
+ * BUZZER_TRACE_EV_CALLBACK : buzzer_end_callback() will be called
+ */
+typedef enum{
+    BUZZER_TRACE_EV_START = 1,
+    BUZZER_TRACE_EV_STOP,
+    BUZZER_TRACE_EV_NOTE,
+    BUZZER_TRACE_EV_PREEMPT,
+    BUZZER_TRACE_EV_CALLBACK
+}buzzer_trace_ev_e;
+
+/*
+ * Structs and Unions
+ */
+
+/**
+ * @brief one trace record, always 8 bytes
+ */
+typedef struct{
+    uint32_t timestamp;
+    uint16_t freq;
+    uint8_t instance;
+    uint8_t event;
+}buzzer_trace_rec_t;
+
+/**
+ * @brief the ring buffer. head counts all the pushed records, so the
+ * oldest valid record is on (head - len) when head > len
+ */
+typedef struct{
+    uint32_t magic;
+    uint16_t len;
+    uint16_t recSize;
+    volatile uint32_t head;
+    buzzer_trace_rec_t rec[BUZZER_TRACE_LEN];
+}buzzer_trace_buf_t;
+
+/*
+ * Functions Prototypes
+ */
+
+#if BUZZER_USE_TRACE
+
+extern buzzer_trace_buf_t buzzer_trace;
+
+/**
+ * @brief return the timestamp of the records, weak, the default
+ * implementation returns 0 and the records are only ordered
+ *
+ * @return uint32_t
+ */
+uint32_t buzzer_trace_timestamp(void);
+
+/**
+ * @brief discard all the records
+ */
+void buzzer_trace_clear(void);
+
+/**
+ * @brief push a record. The slot is reserved in a critical section (see
+ * BUZZER_CRITICAL_ENTER), so it can be called from the interrupt and from
+ * the application at the same time. It costs a few loads and stores
+ *
+ * @param instance : id of the buzzer
+ * @param event : buzzer_trace_ev_e
+ * @param freq : frequency of the event
+ */
+static inline void buzzer_trace_push(uint8_t instance, uint8_t event, uint16_t freq){
+    buzzer_trace_rec_t *rec;
+    uint32_t slot;
+
+    BUZZER_CRITICAL_ENTER();
+    slot = buzzer_trace.head++;
+    BUZZER_CRITICAL_EXIT();
+    rec = &buzzer_trace.rec[slot & (BUZZER_TRACE_LEN - 1)];
+    rec->timestamp = BUZZER_TRACE_TIMESTAMP();
+    rec->freq = freq;
+    rec->instance = instance;
+    rec->event = event;
+}
+
+#define BUZZER_TRACE(buzzer, ev, freq)	buzzer_trace_push((buzzer)->traceId, (ev), (freq))
+
+#else
+
+#define BUZZER_TRACE(buzzer, ev, freq)	((void)0)
+
+#endif /* BUZZER_USE_TRACE */
+
+#endif /* BUZZER_TRACE_H_ */
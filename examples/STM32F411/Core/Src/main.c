@@ -69,6 +69,17 @@ buzzer_t mBuzzer;
 buzzer_t *Buzzer;
 example_buzzer_e example = EXAMPLE_BUZZER_START;
 uint8_t nextPattern;
+uint32_t pwmFreq;
+uint32_t pwmDuty = 50;
+// soft attack and release, to avoid clicks between the notes
+const buzzer_envelope_t buzzerEnvelope = {
+	.attackMs = 20,
+	.decayMs = 100,
+	.releaseMs = 40,
+	.sustain = 160,
+	.dutyMax = 50,
+	.updateMs = 10
+};
 
 /* USER CODE END PV */
 
@@ -95,9 +106,12 @@ void pwm_start(){
 void pwm_set_dc(uint32_t dc){
 	uint32_t arr, comp;
 
-	arr = __HAL_TIM_GET_AUTORELOAD(PWM_TIM);
-	comp = dc*arr/100;
-	__HAL_TIM_SET_COMPARE(PWM_TIM, PWM_CHN, comp);
+	pwmDuty = dc;
+	if (pwmFreq > 0){
+		arr = __HAL_TIM_GET_AUTORELOAD(PWM_TIM);
+		comp = dc*arr/100;
+		__HAL_TIM_SET_COMPARE(PWM_TIM, PWM_CHN, comp);
+	}
 }
 
 /**
@@ -106,12 +120,13 @@ void pwm_set_dc(uint32_t dc){
 void pwm_set_freq(uint32_t freq){
 	uint32_t psc, arr, sys;
 
+	pwmFreq = freq;
 	if (freq > 0){
 		sys = HAL_RCC_GetSysClockFreq();
 		arr = __HAL_TIM_GET_AUTORELOAD(PWM_TIM);
 		psc = (sys/(freq*(arr+1)))-1;
 		__HAL_TIM_SET_PRESCALER(PWM_TIM, psc);
-		pwm_set_dc(50);
+		pwm_set_dc(pwmDuty);
 	}
 	else
 		__HAL_TIM_SET_COMPARE(PWM_TIM, PWM_CHN, 0);
@@ -134,6 +149,15 @@ void buzzer_end_callback(buzzer_t *buzzer){
 	nextPattern = 1;
 }
 
+// TIM9 only ticks while a tone plays, so the MCU can sleep when silent
+void buzzer_wake_callback(void){
+	HAL_TIM_Base_Start_IT(&htim9);
+}
+
+void buzzer_idle_callback(void){
+	HAL_TIM_Base_Stop_IT(&htim9);
+}
+
 
 /* USER CODE END 0 */
 
@@ -176,11 +200,13 @@ int main(void)
   // Configure the Buzzer object
   Buzzer->interruptMs = 10; // interrupt will be triggered every 10ms
   Buzzer->fnx.pwmOut = pwm_set_freq; // pass set frequency function
+  Buzzer->fnx.pwmDutyOut = pwm_set_dc; // pass set duty cycle function, used by the envelope
 
   // initialize Buzzer
   buzzer_init(Buzzer);
+  buzzer_set_envelope(Buzzer, &buzzerEnvelope);
 
-  HAL_TIM_Base_Start_IT(&htim9);
+  // TIM9 is started by buzzer_wake_callback()
   pwm_start();
 
   nextPattern = 1;
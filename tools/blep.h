@@ -0,0 +1,273 @@
+/*
+ * blep.h
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Band limited square wave (PolyBLEP) for the host previews. A naive
+ *  square wave aliases badly at the high notes (NOTE_C8 and up at 44.1kHz),
+ *  each edge is smoothed by a 2 samples polynomial, that removes most of
+ *  the aliasing for a few multiplies.
+ *
+ *  A bank renders many voices in parallel (one tone preview per voice),
+ *  one voice per SIMD lane, with AVX2 (8 lanes), SSE2 (4 lanes) or the
+ *  portable scalar code, chosen at runtime. The output is interleaved,
+ *  out[sample * voices + voice], in the -1..1 range.
+ */
+
+#ifndef TOOLS_BLEP_H_
+#define TOOLS_BLEP_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BLEP_X86	1
+#else
+#define BLEP_X86	0
+#endif
+
+typedef enum{
+    BLEP_SCALAR,
+    BLEP_SSE2,
+    BLEP_AVX2
+}blep_isa_e;
+
+/**
+ * @brief voices in structure of arrays. The frequency and duty of a
+ * voice can change between blep_render() calls, with blep_set()
+ */
+typedef struct{
+    uint32_t voices;
+    float *phase;
+    float *inc;         // freq / rate
+    float *idt;         // 1 / inc
+    float *duty;        // 0..1, 0 or a freq of 0 is silence
+    float *amp;
+    blep_isa_e isa;
+}blep_bank_t;
+
+static inline blep_isa_e blep_best_isa(void){
+#if BLEP_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")){
+        return BLEP_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")){
+        return BLEP_SSE2;
+    }
+#endif
+    return BLEP_SCALAR;
+}
+
+static inline int blep_init(blep_bank_t *bank, uint32_t voices){
+    float *mem = (float*)calloc((size_t)voices * 5, sizeof(float));
+
+    bank->isa = blep_best_isa();
+    bank->voices = (mem != NULL) ? voices : 0;
+    bank->phase = mem;
+    bank->inc = mem + voices;
+    bank->idt = mem + voices * 2;
+    bank->duty = mem + voices * 3;
+    bank->amp = mem + voices * 4;
+
+    return (mem != NULL) ? 0 : -1;
+}
+
+static inline void blep_free(blep_bank_t *bank){
+    free(bank->phase);
+    bank->phase = NULL;
+}
+
+/**
+ * @brief set the voice output, duty in %, as pwmDutyOut
+ */
+static inline void blep_set(blep_bank_t *bank, uint32_t v, uint32_t freq, uint32_t duty, float rate){
+    float inc = (float)freq / rate;
+
+    if (freq == 0 || duty == 0 || inc >= 0.5f){
+        // off, or above Nyquist, the piezo won't play it either
+        bank->inc[v] = 0;
+        bank->idt[v] = 0;
+        bank->amp[v] = 0;
+        return;
+    }
+    bank->inc[v] = inc;
+    bank->idt[v] = 1.0f / inc;
+    bank->duty[v] = (float)duty / 100.0f;
+    bank->amp[v] = 1.0f;
+}
+
+// scalar
+
+static inline float __blep_poly(float t, float dt, float idt){
+    float x;
+
+    if (t < dt){
+        x = t * idt;
+        return x + x - x * x - 1.0f;
+    }
+    if (t > 1.0f - dt){
+        x = (t - 1.0f) * idt;
+        return x * x + x + x + 1.0f;
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief one sample of a voice, advances the phase
+ */
+static inline float blep_sample(float *phase, float inc, float idt, float duty){
+    float t = *phase;
+    float t2 = t + 1.0f - duty;
+    float y;
+
+    t2 -= (t2 >= 1.0f) ? 1.0f : 0.0f;
+    y = (t < duty) ? 1.0f : -1.0f;
+    y += __blep_poly(t, inc, idt) - __blep_poly(t2, inc, idt);
+    t += inc;
+    *phase = t - ((t >= 1.0f) ? 1.0f : 0.0f);
+
+    // without the DC of the duty cycle
+    return y - (duty + duty - 1.0f);
+}
+
+static inline void __blep_render_scalar(blep_bank_t *bank, float *out, uint32_t v0, uint32_t len){
+    uint32_t n = bank->voices;
+    uint32_t v, i;
+    float phase;
+
+    for (v = v0 ; v < n ; v++){
+        phase = bank->phase[v];
+        for (i = 0 ; i < len ; i++){
+            out[(size_t)i * n + v] = bank->amp[v] *
+                    blep_sample(&phase, bank->inc[v], bank->idt[v], bank->duty[v]);
+        }
+        bank->phase[v] = phase;
+    }
+}
+
+#if BLEP_X86
+
+// SSE2, 4 voices per lane group
+
+__attribute__((target("sse2")))
+static inline __m128 __blep_poly_sse2(__m128 t, __m128 dt, __m128 idt){
+    const __m128 one = _mm_set1_ps(1.0f);
+    __m128 x1 = _mm_mul_ps(t, idt);
+    __m128 x2 = _mm_mul_ps(_mm_sub_ps(t, one), idt);
+    __m128 r1 = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(x1, x1), _mm_mul_ps(x1, x1)), one);
+    __m128 r2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x2, x2), _mm_add_ps(x2, x2)), one);
+    __m128 m1 = _mm_cmplt_ps(t, dt);
+    __m128 m2 = _mm_cmpgt_ps(t, _mm_sub_ps(one, dt));
+
+    return _mm_or_ps(_mm_and_ps(m1, r1), _mm_and_ps(m2, r2));
+}
+
+__attribute__((target("sse2")))
+static inline uint32_t __blep_render_sse2(blep_bank_t *bank, float *out, uint32_t len){
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    uint32_t n = bank->voices;
+    uint32_t v, i;
+
+    for (v = 0 ; v + 4 <= n ; v += 4){
+        __m128 t = _mm_loadu_ps(bank->phase + v);
+        __m128 dt = _mm_loadu_ps(bank->inc + v);
+        __m128 idt = _mm_loadu_ps(bank->idt + v);
+        __m128 d = _mm_loadu_ps(bank->duty + v);
+        __m128 a = _mm_loadu_ps(bank->amp + v);
+        // naive square of -1/1, minus the DC, in one: (t < d) * 2 - 2d
+        __m128 dc = _mm_add_ps(d, d);
+        __m128 shift = _mm_sub_ps(one, d);
+
+        for (i = 0 ; i < len ; i++){
+            __m128 t2 = _mm_add_ps(t, shift);
+            __m128 y;
+
+            t2 = _mm_sub_ps(t2, _mm_and_ps(_mm_cmpge_ps(t2, one), one));
+            y = _mm_sub_ps(_mm_and_ps(_mm_cmplt_ps(t, d), two), dc);
+            y = _mm_add_ps(y, __blep_poly_sse2(t, dt, idt));
+            y = _mm_sub_ps(y, __blep_poly_sse2(t2, dt, idt));
+            _mm_storeu_ps(out + (size_t)i * n + v, _mm_mul_ps(y, a));
+            t = _mm_add_ps(t, dt);
+            t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpge_ps(t, one), one));
+        }
+        _mm_storeu_ps(bank->phase + v, t);
+    }
+
+    return v;
+}
+
+// AVX2, 8 voices per lane group
+
+__attribute__((target("avx2")))
+static inline __m256 __blep_poly_avx2(__m256 t, __m256 dt, __m256 idt){
+    const __m256 one = _mm256_set1_ps(1.0f);
+    __m256 x1 = _mm256_mul_ps(t, idt);
+    __m256 x2 = _mm256_mul_ps(_mm256_sub_ps(t, one), idt);
+    __m256 r1 = _mm256_sub_ps(_mm256_sub_ps(_mm256_add_ps(x1, x1), _mm256_mul_ps(x1, x1)), one);
+    __m256 r2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x2, x2), _mm256_add_ps(x2, x2)), one);
+    __m256 m1 = _mm256_cmp_ps(t, dt, _CMP_LT_OQ);
+    __m256 m2 = _mm256_cmp_ps(t, _mm256_sub_ps(one, dt), _CMP_GT_OQ);
+
+    return _mm256_or_ps(_mm256_and_ps(m1, r1), _mm256_and_ps(m2, r2));
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t __blep_render_avx2(blep_bank_t *bank, float *out, uint32_t len){
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    uint32_t n = bank->voices;
+    uint32_t v, i;
+
+    for (v = 0 ; v + 8 <= n ; v += 8){
+        __m256 t = _mm256_loadu_ps(bank->phase + v);
+        __m256 dt = _mm256_loadu_ps(bank->inc + v);
+        __m256 idt = _mm256_loadu_ps(bank->idt + v);
+        __m256 d = _mm256_loadu_ps(bank->duty + v);
+        __m256 a = _mm256_loadu_ps(bank->amp + v);
+        __m256 dc = _mm256_add_ps(d, d);
+        __m256 shift = _mm256_sub_ps(one, d);
+
+        for (i = 0 ; i < len ; i++){
+            __m256 t2 = _mm256_add_ps(t, shift);
+            __m256 y;
+
+            t2 = _mm256_sub_ps(t2, _mm256_and_ps(_mm256_cmp_ps(t2, one, _CMP_GE_OQ), one));
+            y = _mm256_sub_ps(_mm256_and_ps(_mm256_cmp_ps(t, d, _CMP_LT_OQ), two), dc);
+            y = _mm256_add_ps(y, __blep_poly_avx2(t, dt, idt));
+            y = _mm256_sub_ps(y, __blep_poly_avx2(t2, dt, idt));
+            _mm256_storeu_ps(out + (size_t)i * n + v, _mm256_mul_ps(y, a));
+            t = _mm256_add_ps(t, dt);
+            t = _mm256_sub_ps(t, _mm256_and_ps(_mm256_cmp_ps(t, one, _CMP_GE_OQ), one));
+        }
+        _mm256_storeu_ps(bank->phase + v, t);
+    }
+
+    return v;
+}
+
+#endif
+
+/**
+ * @brief render len samples of every voice to out, that must have
+ * len * voices floats. The voices that don't fill a SIMD lane group are
+ * rendered by the scalar code
+ */
+static inline void blep_render(blep_bank_t *bank, float *out, uint32_t len){
+    uint32_t v = 0;
+
+#if BLEP_X86
+    if (bank->isa == BLEP_AVX2){
+        v = __blep_render_avx2(bank, out, len);
+    }
+    else if (bank->isa == BLEP_SSE2){
+        v = __blep_render_sse2(bank, out, len);
+    }
+#endif
+    __blep_render_scalar(bank, out, v, len);
+}
+
+#endif /* TOOLS_BLEP_H_ */
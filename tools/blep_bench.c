@@ -0,0 +1,163 @@
+/*
+ * blep_bench.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Throughput of the band limited renderer (blep.h), in samples per second
+ *  on one core, for each instruction set available. The SIMD output is
+ *  checked against the scalar code, and the aliasing of a naive square and
+ *  of the PolyBLEP one is reported for the highest notes.
+ *
+ *  build : gcc -O2 -I.. -o blep_bench blep_bench.c -lm
+ *  usage : blep_bench [voices]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "notes.h"
+#include "blep.h"
+
+#define _RATE		44100.0f
+#define _BLOCK		256
+#define _RUN_MS		300.0
+#define _DFT_LEN	4096
+
+static const char *_isaName[] = {"scalar", "sse2", "avx2"};
+
+static double _now_ms(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void _setup(blep_bank_t *bank){
+    static const uint16_t notes[] = {NOTE_C4, NOTE_A4, NOTE_E5, NOTE_C6, NOTE_G6,
+            NOTE_C7, NOTE_C8, NOTE_DS8};
+    uint32_t v;
+
+    for (v = 0 ; v < bank->voices ; v++){
+        blep_set(bank, v, notes[v % 8], 10 + (v * 7) % 41, _RATE);
+        bank->phase[v] = (float)(v % 97) / 97.0f;
+    }
+}
+
+static void _bench(uint32_t voices, blep_isa_e isa){
+    blep_bank_t bank;
+    float *out = malloc(sizeof(float) * voices * _BLOCK);
+    uint64_t samples = 0;
+    double t0, elapsed;
+
+    blep_init(&bank, voices);
+    bank.isa = isa;
+    _setup(&bank);
+    t0 = _now_ms();
+    do{
+        blep_render(&bank, out, _BLOCK);
+        samples += (uint64_t)voices * _BLOCK;
+        elapsed = _now_ms() - t0;
+    }while (elapsed < _RUN_MS);
+    printf("%-8s %10.1f Msamples/s per core %8.0f voices at 44.1kHz\n",
+            _isaName[isa], samples / elapsed / 1000.0,
+            samples / elapsed * 1000.0 / _RATE);
+    blep_free(&bank);
+    free(out);
+}
+
+static float _check(uint32_t voices, blep_isa_e isa){
+    blep_bank_t ref, bank;
+    float *a = malloc(sizeof(float) * voices * _BLOCK);
+    float *b = malloc(sizeof(float) * voices * _BLOCK);
+    float err = 0;
+    uint32_t i;
+
+    blep_init(&ref, voices);
+    blep_init(&bank, voices);
+    ref.isa = BLEP_SCALAR;
+    bank.isa = isa;
+    _setup(&ref);
+    _setup(&bank);
+    blep_render(&ref, a, _BLOCK);
+    blep_render(&bank, b, _BLOCK);
+    for (i = 0 ; i < voices * _BLOCK ; i++){
+        err = fmaxf(err, fabsf(a[i] - b[i]));
+    }
+    blep_free(&ref);
+    blep_free(&bank);
+    free(a);
+    free(b);
+
+    return err;
+}
+
+/**
+ * energy out of the harmonics, relative to the total, in dB
+ */
+static double _alias_db(const float *x, float freq){
+    double total = 0, alias = 0;
+    uint32_t k, i, h;
+
+    for (k = 1 ; k < _DFT_LEN / 2 ; k++){
+        double re = 0, im = 0, p, bin = k * _RATE / _DFT_LEN;
+        int harmonic = 0;
+
+        for (i = 0 ; i < _DFT_LEN ; i++){
+            double w = 0.5 - 0.5 * cos(2 * M_PI * i / _DFT_LEN);
+            re += w * x[i] * cos(2 * M_PI * k * i / _DFT_LEN);
+            im -= w * x[i] * sin(2 * M_PI * k * i / _DFT_LEN);
+        }
+        p = re * re + im * im;
+        for (h = 1 ; h * freq < _RATE / 2 ; h++){
+            if (fabs(bin - h * freq) < 3 * _RATE / _DFT_LEN){
+                harmonic = 1;
+            }
+        }
+        total += p;
+        alias += harmonic ? 0 : p;
+    }
+
+    return 10 * log10(alias / total);
+}
+
+static void _aliasing(uint16_t note, const char *name){
+    static float naive[_DFT_LEN], smooth[_DFT_LEN];
+    float phase = 0, inc = note / _RATE;
+    blep_bank_t bank;
+    uint32_t i;
+
+    for (i = 0 ; i < _DFT_LEN ; i++){
+        naive[i] = (phase < 0.5f) ? 1.0f : -1.0f;
+        phase += inc;
+        phase -= (phase >= 1.0f) ? 1.0f : 0.0f;
+    }
+    blep_init(&bank, 1);
+    blep_set(&bank, 0, note, 50, _RATE);
+    blep_render(&bank, smooth, _DFT_LEN);
+    blep_free(&bank);
+    printf("%-8s naive %6.1f dB  polyblep %6.1f dB of aliasing\n", name,
+            _alias_db(naive, note), _alias_db(smooth, note));
+}
+
+int main(int argc, char **argv){
+    uint32_t voices = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1024;
+    blep_isa_e best = blep_best_isa();
+    uint32_t isa;
+
+    if (voices == 0){
+        return 1;
+    }
+    for (isa = BLEP_SCALAR ; isa <= best ; isa++){
+        if (isa != BLEP_SCALAR){
+            printf("%-8s max error %g from scalar\n", _isaName[isa], _check(voices, isa));
+        }
+        _bench(voices, isa);
+    }
+    _aliasing(NOTE_C7, "NOTE_C7");
+    _aliasing(NOTE_C8, "NOTE_C8");
+    _aliasing(NOTE_DS8, "NOTE_DS8");
+
+    return 0;
+}
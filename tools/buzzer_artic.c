@@ -0,0 +1,332 @@
+/*
+ * buzzer_artic.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Folds the rest entries of a melody into the articulation of the note
+ *  before them (see pArtic of buzzer_melody_t), and prints the new arrays
+ *  as C. Both versions are played on the host and the output edges are
+ *  compared tick by tick, a rest is only folded when the articulation
+ *  reproduces it exactly. The folded melody is also played on an Active
+ *  device without pitches, and its edges are compared with the cuts.
+ *
+ *  build : gcc -O2 -I.. -o buzzer_artic buzzer_artic.c ../buzzer.c ../ringtones.c
+ *  usage : buzzer_artic [-i ms] [-n name] <mario | underworld | file>
+ *          -i ms     interruptMs of the target (default 1), the note edges
+ *                    are on its ticks
+ *          -n name   prefix of the printed arrays (default the input name)
+ *          file      one "period freq" pair per line
+ *
+ *  exit 1 when the outputs differ.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buzzer.h"
+
+#define _MAX_NOTES		1024
+#define _MAX_EDGES		4096
+#define _MAX_TICKS		600000
+
+typedef struct{
+    uint16_t times[_MAX_NOTES];
+    uint16_t freq[_MAX_NOTES];
+    uint8_t artic[_MAX_NOTES];
+    uint16_t len;
+}artic_melody_t;
+
+typedef struct{
+    uint32_t tick;
+    uint32_t freq;
+}artic_edge_t;
+
+static artic_edge_t _edges[_MAX_EDGES];
+static uint32_t _nEdges;
+static uint32_t _tick;
+static uint32_t _interruptMs = 1;
+
+static void _pwm_out(uint32_t freq){
+    if (_nEdges < _MAX_EDGES){
+        _edges[_nEdges].tick = _tick;
+        _edges[_nEdges].freq = freq;
+    }
+    _nEdges++;
+}
+
+static uint32_t _gpio;
+
+static void _gpio_out(uint32_t val){
+    if (val == _gpio){
+        return;
+    }
+    _gpio = val;
+    _pwm_out(val);
+}
+
+/**
+ * ms that a note of period time lasts, the edge is on the first tick
+ * after the time
+ */
+static uint32_t _duration(uint32_t time){
+    return (time / _interruptMs + 1) * _interruptMs;
+}
+
+/**
+ * articulation that cuts a note of period time after sound ms, as
+ * computed by the engine, 0 when there is none
+ */
+static uint8_t _artic_for(uint32_t time, uint32_t sound){
+    uint32_t p;
+
+    for (p = 1 ; p < 100 ; p++){
+        if (_duration(time * p / 100) == sound){
+            return p;
+        }
+    }
+    return 0;
+}
+
+static void _fold(const artic_melody_t *in, artic_melody_t *out){
+    uint32_t total = 0, sound = 0;
+    uint16_t i, n = 0;
+
+    for (i = 0 ; i < in->len ; i++){
+        uint32_t d = _duration(in->times[i]);
+        uint32_t time = total + d - _interruptMs;
+        uint8_t p;
+
+        if (in->freq[i] == 0 && n > 0 && time <= UINT16_MAX){
+            if (out->freq[n - 1] == 0){
+                // rests are merged, without articulation
+                out->times[n - 1] = time;
+                total += d;
+                continue;
+            }
+            p = _artic_for(time, sound);
+            if (p != 0){
+                out->times[n - 1] = time;
+                out->artic[n - 1] = p;
+                total += d;
+                continue;
+            }
+        }
+        out->times[n] = in->times[i];
+        out->freq[n] = in->freq[i];
+        out->artic[n] = 0;
+        n++;
+        total = d;
+        sound = d;
+    }
+    out->len = n;
+}
+
+/**
+ * plays the melody and copies its output edges, returns the number of
+ * edges and of calls of the state handler (note edges and cuts)
+ */
+static uint32_t _record(const artic_melody_t *m, artic_edge_t *edges, uint32_t *noteEdges){
+    buzzer_t buzzer = {0};
+    buzzer_melody_t melody = {
+        .pTimes = (uint16_t *)m->times,
+        .pFreq = (uint16_t *)m->freq,
+        .pArtic = (uint8_t *)m->artic,
+        .len = m->len
+    };
+    uint32_t n, changes = 0;
+
+    buzzer.fnx.pwmOut = _pwm_out;
+    buzzer.interruptMs = _interruptMs;
+    buzzer_init(&buzzer);
+
+    _nEdges = 0;
+    _tick = 0;
+    buzzer_start_melody(&buzzer, &melody);
+    for (n = 0 ; n < _MAX_TICKS && buzzer.active ; n++){
+        _tick += _interruptMs;
+        buzzer_interrupt(&buzzer);
+        if (buzzer.counting == 0){
+            changes++;
+        }
+    }
+    *noteEdges = changes;
+    n = (_nEdges < _MAX_EDGES) ? _nEdges : _MAX_EDGES;
+    memcpy(edges, _edges, n * sizeof(artic_edge_t));
+
+    return _nEdges;
+}
+
+/**
+ * plays the melody on an Active device, without pFreq, and compares its
+ * edges with the expected ones: high on each note after a cut, low after
+ * the sound of the articulation and at the end. Returns 0 when they match
+ */
+static int _check_active(const artic_melody_t *m){
+    static artic_edge_t expected[_MAX_EDGES];
+    buzzer_t buzzer = {0};
+    buzzer_melody_t melody = {
+        .pTimes = (uint16_t *)m->times,
+        .pFreq = NULL,
+        .pArtic = (uint8_t *)m->artic,
+        .len = m->len
+    };
+    uint32_t n = 0, t = 0, on = 0, i;
+
+    for (i = 0 ; i < m->len ; i++){
+        uint32_t sound = _duration(m->times[i] * m->artic[i] / 100);
+
+        if (!on && n < _MAX_EDGES){
+            expected[n].tick = t;
+            expected[n++].freq = 1;
+            on = 1;
+        }
+        if (m->artic[i] != 0 && sound <= m->times[i] && n < _MAX_EDGES){
+            expected[n].tick = t + sound;
+            expected[n++].freq = 0;
+            on = 0;
+        }
+        t += _duration(m->times[i]);
+    }
+    if (on && n < _MAX_EDGES){
+        expected[n].tick = t;
+        expected[n++].freq = 0;
+    }
+
+    buzzer.fnx.gpioOut = _gpio_out;
+    buzzer.interruptMs = _interruptMs;
+    buzzer_init(&buzzer);
+
+    _nEdges = 0;
+    _tick = 0;
+    _gpio = 0;
+    buzzer_start_melody(&buzzer, &melody);
+    for (i = 0 ; i < _MAX_TICKS && buzzer.active ; i++){
+        _tick += _interruptMs;
+        buzzer_interrupt(&buzzer);
+    }
+
+    if (_nEdges != n){
+        fprintf(stderr, "FAIL, Active, %u output edges, expected %u\n", _nEdges, n);
+        return 1;
+    }
+    for (i = 0 ; i < n && i < _MAX_EDGES ; i++){
+        if (_edges[i].tick != expected[i].tick || _edges[i].freq != expected[i].freq){
+            fprintf(stderr, "FAIL, Active, edge %u: %u at %u ms, expected %u at %u ms\n", i,
+                    _edges[i].freq, _edges[i].tick, expected[i].freq, expected[i].tick);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int _load_file(const char *path, artic_melody_t *m){
+    FILE *f = fopen(path, "r");
+    unsigned time, freq;
+
+    if (f == NULL){
+        return -1;
+    }
+    m->len = 0;
+    while (m->len < _MAX_NOTES && fscanf(f, "%u %u", &time, &freq) == 2){
+        m->times[m->len] = time;
+        m->freq[m->len] = freq;
+        m->artic[m->len] = 0;
+        m->len++;
+    }
+    fclose(f);
+
+    return 0;
+}
+
+static void _load_array(artic_melody_t *m, const uint16_t *times, const uint16_t *freq, uint16_t len){
+    m->len = (len < _MAX_NOTES) ? len : _MAX_NOTES;
+    memcpy(m->times, times, m->len * sizeof(uint16_t));
+    memcpy(m->freq, freq, m->len * sizeof(uint16_t));
+    memset(m->artic, 0, m->len);
+}
+
+static void _print_array(const char *type, const char *name, const char *suffix,
+        const void *values, uint16_t len, int bytes){
+    uint16_t i;
+
+    printf("%s %s_%s[] = {", type, name, suffix);
+    for (i = 0 ; i < len ; i++){
+        printf("%s%u%s", (i % 12) ? " " : "\n\t",
+                bytes == 1 ? ((const uint8_t *)values)[i] : ((const uint16_t *)values)[i],
+                (i + 1 < len) ? "," : "");
+    }
+    printf("\n};\n");
+}
+
+int main(int argc, char **argv){
+    static artic_melody_t in, out;
+    static artic_edge_t inEdges[_MAX_EDGES], outEdges[_MAX_EDGES];
+    const char *src = NULL, *name = NULL;
+    uint32_t nIn, nOut, inNotes, outNotes, i;
+    int a;
+
+    for (a = 1 ; a < argc ; a++){
+        if (strcmp(argv[a], "-i") == 0 && a + 1 < argc){
+            _interruptMs = strtoul(argv[++a], NULL, 0);
+        }
+        else if (strcmp(argv[a], "-n") == 0 && a + 1 < argc){
+            name = argv[++a];
+        }
+        else{
+            src = argv[a];
+        }
+    }
+    if (src == NULL || _interruptMs == 0){
+        fprintf(stderr, "usage: buzzer_artic [-i ms] [-n name] <mario | underworld | file>\n");
+        return 2;
+    }
+
+    if (strcmp(src, "mario") == 0){
+        _load_array(&in, mario_theme_time, mario_theme_melody, mario_theme_len);
+    }
+    else if (strcmp(src, "underworld") == 0){
+        _load_array(&in, underworld_time, underworld_melody, underworld_len);
+    }
+    else if (_load_file(src, &in) != 0){
+        fprintf(stderr, "can't read %s\n", src);
+        return 2;
+    }
+    if (name == NULL){
+        static char base[64];
+
+        // file name without the path and the extension
+        strncpy(base, (strchr(src, '/') != NULL) ? strrchr(src, '/') + 1 : src, sizeof(base) - 1);
+        if (strchr(base, '.') != NULL){
+            *strchr(base, '.') = '\0';
+        }
+        name = base;
+    }
+
+    _fold(&in, &out);
+    nIn = _record(&in, inEdges, &inNotes);
+    nOut = _record(&out, outEdges, &outNotes);
+
+    printf("// %s, %u notes folded to %u, %u bytes to %u, note edges %u to %u\n",
+            name, in.len, out.len, in.len * 4, out.len * 5, inNotes, outNotes);
+    _print_array("uint16_t", name, "time", out.times, out.len, 2);
+    _print_array("uint16_t", name, "melody", out.freq, out.len, 2);
+    _print_array("uint8_t", name, "artic", out.artic, out.len, 1);
+    printf("uint16_t %s_len = %u;\n", name, out.len);
+
+    if (nIn != nOut || nIn > _MAX_EDGES){
+        fprintf(stderr, "FAIL, %u output edges, expected %u\n", nOut, nIn);
+        return 1;
+    }
+    for (i = 0 ; i < nIn ; i++){
+        if (inEdges[i].tick != outEdges[i].tick || inEdges[i].freq != outEdges[i].freq){
+            fprintf(stderr, "FAIL, edge %u: %u Hz at %u ms, expected %u Hz at %u ms\n", i,
+                    outEdges[i].freq, outEdges[i].tick, inEdges[i].freq, inEdges[i].tick);
+            return 1;
+        }
+    }
+
+    return _check_active(&out);
+}
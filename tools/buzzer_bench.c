@@ -0,0 +1,403 @@
+/*
+ * buzzer_bench.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Host benchmark of buzzer_interrupt(), reports the mean cost per call
+ *  and per output edge of each playback mode. Numbers are host cycles
+ *  (rdtsc on x86, nanoseconds elsewhere), use them to compare modes and
+ *  revisions, on the target measure with the DWT cycle counter.
+ *
+ *  build : gcc -O2 -I.. -o buzzer_bench buzzer_bench.c ../buzzer.c ../buzzer_multi.c \
+ *          ../buzzer_pcm.c ../ringtones.c
+ *  specialized engine (see buzzer_bench_port.h), to compare the cycles
+ *  and the size with the runtime one:
+ *          gcc -O2 -I.. -I. -DBUZZER_PORT_HEADER='"buzzer_bench_port.h"' -o buzzer_bench_static \
+ *          buzzer_bench.c ../buzzer.c ../buzzer_multi.c ../buzzer_pcm.c ../ringtones.c
+ *  usage : buzzer_bench [calls]
+ *          buzzer_bench --wcet dir [bound]
+ *
+ *  --wcet replays the worst case inputs saved by buzzer_fuzz.c and fails
+ *  (exit 1) when a call costs more than bound, in host units. The default
+ *  400 leaves a wide margin over the worst call measured on one x86-64
+ *  host, other hosts should pass their own bound.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <dirent.h>
+#include <string.h>
+
+#include "buzzer.h"
+#include "buzzer_multi.h"
+#include "buzzer_pcm.h"
+#include "buzzer_fuzz.h"
+
+// a wide margin over the worst call of the wcet inputs on one x86-64
+// host, for the noise of the measure and the slower hosts
+#define _WCET_BOUND		400
+#define _WCET_RUNS		5
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define _UNIT	"cycles"
+static inline uint64_t _now(void){
+    return __rdtsc();
+}
+#else
+#define _UNIT	"ns"
+static inline uint64_t _now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+typedef void (*bench_start_fx)(buzzer_t *buzzer);
+
+// not static, also written by the outputs of buzzer_bench_port.h
+uint32_t benchEdges;
+volatile uint32_t benchSink;
+
+static buzzer_chord_t _chords[] = {
+    {{NOTE_C5, NOTE_E5, NOTE_G5, 0}},
+    {{NOTE_F5, NOTE_A5, NOTE_C6, 0}},
+    {{NOTE_G5, NOTE_B5, NOTE_D6, NOTE_F6}},
+    {{0}}
+};
+static uint16_t _chordTimes[] = {500, 500, 500, 250};
+
+static uint16_t _multiFreq[] = {
+    NOTE_C5, NOTE_E5, NOTE_G5, NOTE_C4,
+    NOTE_F5, NOTE_A5, NOTE_C6, NOTE_F4,
+    NOTE_G5, NOTE_B5, NOTE_D6, NOTE_G4,
+    0, 0, 0, 0
+};
+
+static void _multi_pwm_out(const uint32_t *freq, uint32_t changed){
+    benchSink = freq[0] + changed;
+    benchEdges++;
+}
+
+static uint16_t _sirenFreq[] = {800, BUZZER_GLIDE_LIN(1600), BUZZER_GLIDE_EXP(800)};
+static uint16_t _sirenTimes[] = {1, 1000, 1000};
+
+static void _pwm_out(uint32_t freq){
+    benchSink = freq;
+    benchEdges++;
+}
+
+static void _start_idle(buzzer_t *buzzer){
+    (void)buzzer;
+}
+
+static void _start_hold(buzzer_t *buzzer){
+    buzzer_turn_on(buzzer, 2500);
+}
+
+static void _start_timed(buzzer_t *buzzer){
+    buzzer_start(buzzer, 2500, 50, BUZZER_LOOP_OFF);
+}
+
+static void _start_blink(buzzer_t *buzzer){
+    buzzer_start(buzzer, 2500, 50, BUZZER_LOOP_ON);
+}
+
+static void _start_array(buzzer_t *buzzer){
+    buzzer_start_array(buzzer, mario_theme_time, mario_theme_melody, mario_theme_len);
+}
+
+static void _start_chord(buzzer_t *buzzer){
+    buzzer_start_chord_array(buzzer, _chordTimes, _chords, sizeof(_chordTimes) / sizeof(_chordTimes[0]));
+}
+
+static void _start_glide(buzzer_t *buzzer){
+    buzzer_start_array(buzzer, _sirenTimes, _sirenFreq, 3);
+}
+
+#if BUZZER_USE_PACKED
+// E7:8 E7 R C7, whole note of 960ms
+static const uint8_t _packed[] = {
+    0xC0, 0x03, 0x04, 0x00,
+    78 | BUZZER_PACKED_DUR_FLAG, 8, 78, 0, 74
+};
+
+static void _start_packed(buzzer_t *buzzer){
+    buzzer_start_packed(buzzer, _packed);
+}
+#endif
+
+#if BUZZER_USE_PATTERN
+// two short beeps and a pause, 20ms slots
+static const buzzer_pattern_t _pattern = {
+    .mask = 0x05,
+    .freq = 2500,
+    .slotMs = 20,
+    .bits = BUZZER_PATTERN_BITS(16, BUZZER_PATTERN_FOREVER)
+};
+
+static void _start_pattern(buzzer_t *buzzer){
+    buzzer_start_pattern(buzzer, &_pattern);
+}
+#endif
+
+#if BUZZER_USE_BURST
+// 3 pulses of 20ms, 10ms apart, and a pause of 50ms
+static const buzzer_burst_t _burst = {
+    .freq = 2500,
+    .onMs = 20,
+    .offMs = 10,
+    .pauseMs = 50,
+    .pulses = 3,
+    .repeat = BUZZER_BURST_FOREVER
+};
+
+static void _start_burst(buzzer_t *buzzer){
+    buzzer_start_burst(buzzer, &_burst);
+}
+#endif
+
+#if BUZZER_USE_MORSE
+// 60 wpm, dits of 20ms
+static const buzzer_morse_t _morse = {
+    .text = "E42 SN 1234567890 ",
+    .freq = 700,
+    .wpm = 60
+};
+
+static void _start_morse(buzzer_t *buzzer){
+    buzzer_start_morse(buzzer, &_morse);
+}
+#endif
+
+static void _bench(const char *name, bench_start_fx start, uint32_t calls){
+    buzzer_t buzzer = {0};
+    uint64_t t0, total;
+    uint32_t n;
+
+    buzzer.fnx.pwmOut = _pwm_out;
+    buzzer.interruptMs = 1;
+#if BUZZER_USE_CHORDS
+    buzzer.arpeggioMs = 20;
+#endif
+#if BUZZER_USE_GLIDE
+    buzzer.glideStepMs = 5;
+#endif
+    buzzer_init(&buzzer);
+    start(&buzzer);
+    benchEdges = 0;
+
+    t0 = _now();
+    for (n = 0 ; n < calls ; n++){
+        buzzer_interrupt(&buzzer);
+        if (!buzzer.active){
+            start(&buzzer);
+        }
+    }
+    total = _now() - t0;
+
+    printf("%-10s %10.2f %s/call %10.2f %s/edge %8u edges\n", name,
+            (double)total / calls, _UNIT,
+            benchEdges ? (double)total / benchEdges : 0.0, _UNIT, benchEdges);
+}
+
+static void _bench_multi(uint32_t calls){
+    buzzer_multi_t buzzer = {0};
+    uint64_t t0, total;
+    uint32_t n;
+    uint16_t len = sizeof(_chordTimes) / sizeof(_chordTimes[0]);
+
+    buzzer.fnx.pwmOut = _multi_pwm_out;
+    buzzer.voices = 4;
+    buzzer.interruptMs = 1;
+    buzzer_multi_init(&buzzer);
+    buzzer_multi_start_array(&buzzer, _chordTimes, _multiFreq, len);
+    benchEdges = 0;
+
+    t0 = _now();
+    for (n = 0 ; n < calls ; n++){
+        buzzer_multi_interrupt(&buzzer);
+        if (!buzzer.active){
+            buzzer_multi_start_array(&buzzer, _chordTimes, _multiFreq, len);
+        }
+    }
+    total = _now() - t0;
+
+    printf("%-10s %10.2f %s/call %10.2f %s/edge %8u edges\n", "multi4",
+            (double)total / calls, _UNIT,
+            benchEdges ? (double)total / benchEdges : 0.0, _UNIT, benchEdges);
+}
+
+static void _pcm_start(uint8_t *buf, uint32_t len, uint32_t sampleRate){
+    (void)buf;
+    (void)len;
+    (void)sampleRate;
+}
+
+static void _pcm_stop(void){
+
+}
+
+/**
+ * PCM refill cost, the CPU load grows linearly with the sample rate, so
+ * it is reported per sample and per kHz of sample rate
+ */
+static void _bench_pcm(uint32_t calls){
+    static uint8_t samples[65536];
+    static uint8_t buf[256];
+    buzzer_pcm_t pcm = {0};
+    uint64_t t0, total = 0;
+    uint32_t n, refills = 0;
+    double perSample;
+
+    pcm.fnx.start = _pcm_start;
+    pcm.fnx.stop = _pcm_stop;
+    pcm.buf = buf;
+    pcm.bufLen = sizeof(buf);
+    buzzer_pcm_init(&pcm);
+
+    for (n = 0 ; n < calls ; n += sizeof(buf)){
+        if (!pcm.active){
+            buzzer_pcm_play_array(&pcm, samples, sizeof(samples), 16000);
+        }
+        t0 = _now();
+        buzzer_pcm_half_transfer(&pcm);
+        buzzer_pcm_transfer_complete(&pcm);
+        total += _now() - t0;
+        refills += 2;
+    }
+
+    perSample = (double)total / (refills * (sizeof(buf) / 2));
+    printf("%-10s %10.2f %s/refill %8.3f %s/sample %10.0f %s/s per kHz\n", "pcm",
+            (double)total / refills, _UNIT, perSample, _UNIT,
+            perSample * 1000, _UNIT);
+}
+
+#if BUZZER_USE_SOFTPWM
+static void _gpio_out(uint32_t val){
+    benchSink = val;
+}
+
+/**
+ * Soft PWM of an Active device, 1kHz tone at half volume, called at
+ * 16kHz and writing a set/clear register pair
+ */
+static void _bench_softpwm(uint32_t calls){
+    static volatile uint32_t set, clr;
+    buzzer_t buzzer = {0};
+    uint64_t t0, total;
+    uint32_t n, toggles = 0;
+    uint8_t out = 0;
+
+    buzzer.fnx.gpioOut = _gpio_out;
+    buzzer.interruptMs = 1;
+    buzzer_init(&buzzer);
+    buzzer.softpwm.pSet = &set;
+    buzzer.softpwm.pClr = &clr;
+    buzzer.softpwm.setMask = 1;
+    buzzer.softpwm.clrMask = 1;
+    buzzer_softpwm_init(&buzzer, 16000);
+    buzzer_set_volume(&buzzer, BUZZER_SOFTPWM_LEVELS / 2);
+    buzzer_turn_on(&buzzer, 1000);
+
+    t0 = _now();
+    for (n = 0 ; n < calls ; n++){
+        buzzer_softpwm_interrupt(&buzzer);
+    }
+    total = _now() - t0;
+
+    // same run again, untimed, only counting the pin writes
+    buzzer_turn_on(&buzzer, 1000);
+    for (n = 0 ; n < calls ; n++){
+        buzzer_softpwm_interrupt(&buzzer);
+        toggles += (buzzer.softpwm.out != out);
+        out = buzzer.softpwm.out;
+    }
+
+    printf("%-10s %10.2f %s/call %10.2f %s/toggle %8u toggles\n", "softpwm",
+            (double)total / calls, _UNIT,
+            toggles ? (double)total / toggles : 0.0, _UNIT, toggles);
+}
+#endif
+
+/**
+ * worst call of each regression input of buzzer_fuzz, against a bound
+ */
+static int _bench_wcet(const char *dir, uint64_t bound){
+    static fuzz_ctx_t ctx;
+    static uint8_t data[65536];
+    char path[512];
+    struct dirent *ent;
+    DIR *d = opendir(dir);
+    uint64_t cost;
+    size_t size;
+    FILE *f;
+    int fails = 0, inputs = 0;
+
+    if (d == NULL){
+        fprintf(stderr, "can't open %s\n", dir);
+        return 1;
+    }
+    while ((ent = readdir(d)) != NULL){
+        if (ent->d_name[0] == '.'){
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", dir, ent->d_name);
+        f = fopen(path, "rb");
+        if (f == NULL){
+            continue;
+        }
+        size = fread(data, 1, sizeof(data), f);
+        fclose(f);
+        cost = fuzz_measure(&ctx, data, size, _WCET_RUNS);
+        fails += (cost > bound);
+        inputs++;
+        printf("%-24s %8llu %s %s\n", ent->d_name, (unsigned long long)cost,
+                FUZZ_UNIT, (cost > bound) ? "OVER BOUND" : "ok");
+    }
+    closedir(d);
+    printf("%d inputs, %d over %llu %s\n", inputs, fails, (unsigned long long)bound, FUZZ_UNIT);
+
+    return (fails > 0 || inputs == 0);
+}
+
+int main(int argc, char **argv){
+    uint32_t calls = 10000000;
+
+    if (argc > 2 && strcmp(argv[1], "--wcet") == 0){
+        return _bench_wcet(argv[2], (argc > 3) ? strtoull(argv[3], NULL, 0) : _WCET_BOUND);
+    }
+
+    if (argc > 1)
+        calls = strtoul(argv[1], NULL, 0);
+
+    _bench("idle", _start_idle, calls);
+    _bench("hold", _start_hold, calls);
+    _bench("timed", _start_timed, calls);
+    _bench("blink", _start_blink, calls);
+    _bench("array", _start_array, calls);
+#if BUZZER_USE_PACKED
+    _bench("packed", _start_packed, calls);
+#endif
+#if BUZZER_USE_PATTERN
+    _bench("pattern", _start_pattern, calls);
+#endif
+#if BUZZER_USE_BURST
+    _bench("burst", _start_burst, calls);
+#endif
+#if BUZZER_USE_MORSE
+    _bench("morse", _start_morse, calls);
+#endif
+    _bench("chord", _start_chord, calls);
+    _bench("glide", _start_glide, calls);
+    _bench_multi(calls);
+    _bench_pcm(calls);
+#if BUZZER_USE_SOFTPWM
+    _bench_softpwm(calls);
+#endif
+
+    return 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * buzzer_bench_port.h
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Port header of the specialized benchmark build, an engine for Passive
+ *  buzzers only, with a fixed 1ms tick, the output bound at compile time
+ *  and only the modes of the benchmark compiled in
+ */
+
+#ifndef TOOLS_BUZZER_BENCH_PORT_H_
+#define TOOLS_BUZZER_BENCH_PORT_H_
+
+#include <stdint.h>
+
+#define BUZZER_STATIC_TYPE			BUZZER_STATIC_PASSIVE
+#define BUZZER_STATIC_INTERRUPT_MS	1
+
+#define BUZZER_USE_ENVELOPE		0
+#define BUZZER_USE_LFO			0
+#define BUZZER_USE_SFX			0
+#define BUZZER_USE_SOFTPWM		0
+
+extern uint32_t benchEdges;
+extern volatile uint32_t benchSink;
+
+static inline void bench_pwm_out(uint32_t freq){
+    benchSink = freq;
+    benchEdges++;
+}
+
+#define BUZZER_PWM_OUT(freq)	bench_pwm_out(freq)
+
+#endif /* TOOLS_BUZZER_BENCH_PORT_H_ */
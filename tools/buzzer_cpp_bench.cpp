@@ -0,0 +1,239 @@
+/*
+ * buzzer_cpp_bench.cpp
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Host benchmark of the C++ layer (buzzer.hpp) against the C handle with
+ *  the fnx function pointers, same modes and report as buzzer_bench.c.
+ *  The default build measures the cost of the wrapper, the static build
+ *  binds the policy to the engine (see buzzer_cpp_bench_port.h) and with
+ *  -flto the output is inlined in buzzer_interrupt().
+ *
+ *  build : gcc -O2 -flto -I.. -c ../buzzer.c ../ringtones.c && \
+ *          g++ -std=c++17 -O2 -flto -I.. -o buzzer_cpp_bench buzzer_cpp_bench.cpp \
+ *          buzzer.o ringtones.o
+ *  static build :
+ *          gcc -O2 -flto -I.. -I. -DBUZZER_PORT_HEADER='"buzzer_cpp_bench_port.h"' -c \
+ *          ../buzzer.c ../ringtones.c && \
+ *          g++ -std=c++17 -O2 -flto -I.. -I. -DBUZZER_PORT_HEADER='"buzzer_cpp_bench_port.h"' \
+ *          -o buzzer_cpp_bench_static buzzer_cpp_bench.cpp buzzer.o ringtones.o
+ *  usage : buzzer_cpp_bench [calls]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include "buzzer.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define _UNIT	"cycles"
+static inline uint64_t _now(void){
+    return __rdtsc();
+}
+#else
+#define _UNIT	"ns"
+static inline uint64_t _now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+static uint32_t benchEdges;
+static volatile uint32_t benchSink;
+
+/**
+ * the "register" of the PWM, same work as the output of buzzer_bench.c
+ */
+struct BenchPwm{
+    static void pwm(uint32_t freq){
+        benchSink = freq;
+        benchEdges++;
+    }
+};
+
+using BenchBuzzer = buzzer::Buzzer<BenchPwm, buzzer::TickMs<1>>;
+
+static_assert(sizeof(BenchBuzzer) <= sizeof(buzzer_t) + sizeof(uint32_t) * 2,
+        "the wrapper only adds the session counter");
+
+#ifdef BUZZER_PWM_OUT
+BUZZER_CPP_BIND_OUTPUTS(BenchPwm)
+#endif
+
+static buzzer_chord_t _chords[] = {
+    {{NOTE_C5, NOTE_E5, NOTE_G5, 0}},
+    {{NOTE_F5, NOTE_A5, NOTE_C6, 0}},
+    {{NOTE_G5, NOTE_B5, NOTE_D6, NOTE_F6}},
+    {{0}}
+};
+static uint16_t _chordTimes[] = {500, 500, 500, 250};
+
+static uint16_t _sirenFreq[] = {800, BUZZER_GLIDE_LIN(1600), BUZZER_GLIDE_EXP(800)};
+static uint16_t _sirenTimes[] = {1, 1000, 1000};
+
+enum bench_mode_e{
+    _MODE_BLINK,
+    _MODE_ARRAY,
+    _MODE_CHORD,
+    _MODE_GLIDE
+};
+
+static const char *_modeNames[] = {"blink", "array", "chord", "glide"};
+
+static void _report(const char *path, bench_mode_e mode, uint64_t total, uint32_t calls){
+    printf("%-6s %-10s %10.2f %s/call %10.2f %s/edge %8u edges\n", path,
+            _modeNames[mode], (double)total / calls, _UNIT,
+            benchEdges ? (double)total / benchEdges : 0.0, _UNIT, benchEdges);
+}
+
+#ifndef BUZZER_PWM_OUT
+static void _pwm_out(uint32_t freq){
+    benchSink = freq;
+    benchEdges++;
+}
+
+static void _start_c(buzzer_t *buzzer, bench_mode_e mode){
+    switch (mode){
+    case _MODE_BLINK:
+        buzzer_start(buzzer, 2500, 50, BUZZER_LOOP_ON);
+        break;
+    case _MODE_ARRAY:
+        buzzer_start_array(buzzer, mario_theme_time, mario_theme_melody, mario_theme_len);
+        break;
+    case _MODE_CHORD:
+        buzzer_start_chord_array(buzzer, _chordTimes, _chords, 4);
+        break;
+    case _MODE_GLIDE:
+        buzzer_start_array(buzzer, _sirenTimes, _sirenFreq, 3);
+        break;
+    }
+}
+
+/**
+ * the C path, every edge calls the driver through fnx.pwmOut
+ */
+static void _bench_c(bench_mode_e mode, uint32_t calls){
+    buzzer_t buzzer = {};
+    uint64_t t0, total;
+    uint32_t n;
+
+    buzzer.fnx.pwmOut = _pwm_out;
+    buzzer.interruptMs = 1;
+#if BUZZER_USE_CHORDS
+    buzzer.arpeggioMs = 20;
+#endif
+#if BUZZER_USE_GLIDE
+    buzzer.glideStepMs = 5;
+#endif
+    buzzer_init(&buzzer);
+    _start_c(&buzzer, mode);
+    benchEdges = 0;
+
+    t0 = _now();
+    for (n = 0 ; n < calls ; n++){
+        buzzer_interrupt(&buzzer);
+        if (!buzzer.active){
+            _start_c(&buzzer, mode);
+        }
+    }
+    total = _now() - t0;
+
+    _report("c", mode, total, calls);
+}
+#endif
+
+static BenchBuzzer::session_type _start_cpp(BenchBuzzer &buzzer, bench_mode_e mode){
+    switch (mode){
+    case _MODE_BLINK:
+        return buzzer.start(2500, 50, BUZZER_LOOP_ON);
+    case _MODE_ARRAY:
+        return buzzer.start_array(mario_theme_time, mario_theme_melody, mario_theme_len);
+    case _MODE_CHORD:
+        return buzzer.start_chord_array(_chordTimes, _chords);
+    case _MODE_GLIDE:
+    default:
+        return buzzer.start_array(_sirenTimes, _sirenFreq);
+    }
+}
+
+/**
+ * the C++ path, a session per play, replaced when it ends
+ */
+static void _bench_cpp(bench_mode_e mode, uint32_t calls){
+    BenchBuzzer buzzer;
+    uint64_t t0, total;
+    uint32_t n;
+
+#if BUZZER_USE_CHORDS
+    buzzer.c_handle()->arpeggioMs = 20;
+#endif
+#if BUZZER_USE_GLIDE
+    buzzer.c_handle()->glideStepMs = 5;
+#endif
+    auto session = _start_cpp(buzzer, mode);
+    benchEdges = 0;
+
+    t0 = _now();
+    for (n = 0 ; n < calls ; n++){
+        buzzer.tick();
+        if (!session.playing()){
+            session = _start_cpp(buzzer, mode);
+        }
+    }
+    total = _now() - t0;
+
+#ifdef BUZZER_PWM_OUT
+    _report("c++ st", mode, total, calls);
+#else
+    _report("c++", mode, total, calls);
+#endif
+}
+
+/**
+ * the session must stop the play when it goes out of scope
+ */
+static int _check_session(void){
+    BenchBuzzer buzzer;
+    {
+        auto session = buzzer.start(1000, 500);
+        auto moved = static_cast<BenchBuzzer::session_type &&>(session);
+        if (session.playing() || !moved.playing()){
+            return 1;
+        }
+    }
+    if (buzzer.active()){
+        return 1;
+    }
+    // a stale session doesn't stop the newer play
+    auto first = buzzer.start(1000, 500);
+    auto second = buzzer.start(2000, 500);
+    first.stop();
+    return !buzzer.active() || !second.playing();
+}
+
+int main(int argc, char **argv){
+    uint32_t calls = 1000000;
+    int mode;
+
+    if (argc > 1){
+        calls = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+    if (_check_session() != 0){
+        fprintf(stderr, "session check failed\n");
+        return 1;
+    }
+
+    printf("%u calls, 1ms tick\n", calls);
+    for (mode = _MODE_BLINK ; mode <= _MODE_GLIDE ; mode++){
+#ifndef BUZZER_PWM_OUT
+        _bench_c((bench_mode_e)mode, calls);
+#endif
+        _bench_cpp((bench_mode_e)mode, calls);
+    }
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+/*
+ * buzzer_cpp_bench_port.h
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Port header of the static build of buzzer_cpp_bench.cpp, the output of
+ *  the engine is bound to the policy of the benchmark, through the
+ *  functions of BUZZER_CPP_BIND_OUTPUTS() in buzzer.hpp
+ */
+
+#ifndef TOOLS_BUZZER_CPP_BENCH_PORT_H_
+#define TOOLS_BUZZER_CPP_BENCH_PORT_H_
+
+#include <stdint.h>
+
+#define BUZZER_STATIC_TYPE			BUZZER_STATIC_PASSIVE
+#define BUZZER_STATIC_INTERRUPT_MS	1
+
+void buzzer_cpp_pwm_out(uint32_t freq);
+
+#define BUZZER_PWM_OUT(freq)	buzzer_cpp_pwm_out(freq)
+
+#endif /* TOOLS_BUZZER_CPP_BENCH_PORT_H_ */
@@ -0,0 +1,146 @@
+/*
+ * buzzer_daysim.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Simulates a day of a battery product, with key clicks, notifications
+ *  and alarms at random times, and counts the buzzer_interrupt() calls
+ *  when the service timer is stopped by buzzer_idle_callback() and
+ *  restarted by buzzer_wake_callback(), against a timer that is always
+ *  ticking. Fails (exit 1) if the hooks don't pair or an instance is left
+ *  counted as active.
+ *
+ *  build : gcc -O2 -I.. -o buzzer_daysim buzzer_daysim.c ../buzzer.c ../ringtones.c
+ *  usage : buzzer_daysim [clicks] [notifications] [alarms] [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "buzzer.h"
+#include "ringtones.h"
+
+#define _DAY_MS			(24UL * 60 * 60 * 1000)
+#define _INTERRUPT_MS	1
+#define _ALARM_MS		30000
+
+typedef enum{
+    _EV_CLICK,
+    _EV_NOTIFY,
+    _EV_ALARM,
+    _EV_ALARM_OFF
+}_event_e;
+
+typedef struct{
+    uint32_t ms;
+    _event_e ev;
+}_event_t;
+
+static uint8_t _timerOn;
+static uint32_t _wakes, _idles;
+static uint32_t _seed = 1;
+
+void buzzer_wake_callback(void){
+    _timerOn = 1;
+    _wakes++;
+}
+
+void buzzer_idle_callback(void){
+    _timerOn = 0;
+    _idles++;
+}
+
+static void _pwm_out(uint32_t freq){
+    (void)freq;
+}
+
+static uint32_t _rnd(uint32_t max){
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed % max;
+}
+
+static int _cmp(const void *a, const void *b){
+    const _event_t *ea = a, *eb = b;
+
+    return (ea->ms > eb->ms) - (ea->ms < eb->ms);
+}
+
+static void _play(buzzer_t *buzzer, _event_e ev){
+    switch (ev){
+    case _EV_CLICK:
+        buzzer_start(buzzer, 4000, 15, BUZZER_LOOP_OFF);
+        break;
+    case _EV_NOTIFY:
+        buzzer_start_array(buzzer, mario_theme_time, mario_theme_melody, mario_theme_len);
+        break;
+    case _EV_ALARM:
+        buzzer_start(buzzer, 960, 500, BUZZER_LOOP_ON);
+        break;
+    default:
+        buzzer_stop(buzzer);
+        break;
+    }
+}
+
+int main(int argc, char **argv){
+    uint32_t clicks = (argc > 1) ? strtoul(argv[1], NULL, 0) : 2000;
+    uint32_t notify = (argc > 2) ? strtoul(argv[2], NULL, 0) : 50;
+    uint32_t alarms = (argc > 3) ? strtoul(argv[3], NULL, 0) : 4;
+    uint32_t n = clicks + notify + 2 * alarms;
+    _event_t *events = malloc(sizeof(_event_t) * (n + 1));
+    buzzer_t buzzer = {0};
+    uint64_t calls = 0, t = 0;
+    uint32_t i, k = 0;
+
+    _seed = (argc > 4 && strtoul(argv[4], NULL, 0) != 0) ? strtoul(argv[4], NULL, 0) : 1;
+    if (events == NULL){
+        return 1;
+    }
+    for (i = 0 ; i < clicks ; i++){
+        events[k++] = (_event_t){_rnd(_DAY_MS), _EV_CLICK};
+    }
+    for (i = 0 ; i < notify ; i++){
+        events[k++] = (_event_t){_rnd(_DAY_MS), _EV_NOTIFY};
+    }
+    for (i = 0 ; i < alarms ; i++){
+        events[k] = (_event_t){_rnd(_DAY_MS - _ALARM_MS), _EV_ALARM};
+        events[k + 1] = (_event_t){events[k].ms + _ALARM_MS, _EV_ALARM_OFF};
+        k += 2;
+    }
+    qsort(events, n, sizeof(_event_t), _cmp);
+    events[n].ms = _DAY_MS;
+
+    buzzer.fnx.pwmOut = _pwm_out;
+    buzzer.interruptMs = _INTERRUPT_MS;
+    buzzer_init(&buzzer);
+
+    k = 0;
+    while (t < _DAY_MS){
+        if (!_timerOn){
+            // sleeping until the next event, no service calls
+            t = events[k].ms;
+        }
+        while (k < n && events[k].ms <= t){
+            _play(&buzzer, events[k++].ev);
+        }
+        if (_timerOn){
+            t += _INTERRUPT_MS;
+            calls++;
+            buzzer_interrupt(&buzzer);
+        }
+    }
+    buzzer_stop(&buzzer);
+
+    printf("%u clicks, %u notifications, %u alarms of %us\n", clicks, notify, alarms, _ALARM_MS / 1000);
+    printf("always ticking  %10lu service calls\n", _DAY_MS / _INTERRUPT_MS);
+    printf("idle/wake hooks %10llu service calls, %.2f%% of the day awake\n",
+            (unsigned long long)calls, 100.0 * calls * _INTERRUPT_MS / _DAY_MS);
+    printf("%u wakes, %u idles, %u instances left active\n", _wakes, _idles,
+            buzzer_get_active_count());
+    free(events);
+
+    return (_wakes == _idles && buzzer_get_active_count() == 0) ? 0 : 1;
+}
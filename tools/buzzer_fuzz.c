@@ -0,0 +1,232 @@
+/*
+ * buzzer_fuzz.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Searches the inputs that maximize the cost of one buzzer_interrupt()
+ *  call, over every playback mode (see buzzer_fuzz.h). The cost of the
+ *  worst call is the feedback: each new cost bucket (log2 with 2 steps per
+ *  octave) is new "coverage", so the search climbs to the expensive
+ *  inputs. The worst input of each mode is saved as a regression input,
+ *  replayed by buzzer_bench --wcet against a bound.
+ *
+ *  The library state is a fixed size buzzer_t and the decoders don't
+ *  allocate, so the RAM doesn't depend on the input, it is printed with
+ *  the results.
+ *
+ *  libFuzzer (clang):
+ *      clang -O2 -g -fsanitize=fuzzer,address -DBUZZER_FUZZ_LIBFUZZER -I.. \
+ *          -o buzzer_fuzz buzzer_fuzz.c ../buzzer.c
+ *      BUZZER_FUZZ_DIR=wcet ./buzzer_fuzz corpus/
+ *  standalone, with the built in search, or as the AFL target:
+ *      gcc -O2 -I.. -o buzzer_fuzz buzzer_fuzz.c ../buzzer.c
+ *      ./buzzer_fuzz -search 200000 [-s seed] [-o wcet]
+ *      ./buzzer_fuzz file...       (replay, or afl-fuzz -- ./buzzer_fuzz @@)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buzzer_fuzz.h"
+
+#define _RUNS			3
+#define _BUCKETS		64
+#define _INPUT_MAX		(32 + FUZZ_MAX_LEN * 12)
+
+static const char *_modeName[FUZZ_MODES] = {
+    "array", "melody", "chords", "sfx", "blink", "active",
+    "packed", "pattern", "burst", "morse"
+};
+
+static fuzz_ctx_t _ctx;
+static uint64_t _worst[FUZZ_MODES];
+static const char *_dir;
+
+// cost bucket, 2 per octave
+static uint32_t _bucket(uint64_t cost){
+    uint32_t b;
+
+    if (cost < 2){
+        return 0;
+    }
+    b = 63 - __builtin_clzll(cost);
+    b = b * 2 + ((cost >> (b - 1)) & 1);
+
+    return (b < _BUCKETS) ? b : _BUCKETS - 1;
+}
+
+static void _save(const uint8_t *data, size_t size, fuzz_mode_e mode, uint64_t cost){
+    char path[512];
+    FILE *f;
+
+    if (cost <= _worst[mode]){
+        return;
+    }
+    _worst[mode] = cost;
+    if (_dir == NULL){
+        return;
+    }
+    snprintf(path, sizeof(path), "%s/wcet-%s.bin", _dir, _modeName[mode]);
+    f = fopen(path, "wb");
+    if (f != NULL){
+        fwrite(data, 1, size, f);
+        fclose(f);
+    }
+}
+
+static void _report(void){
+    uint32_t m;
+
+    printf("RAM per instance %u bytes, independent of the input\n", (unsigned)sizeof(buzzer_t));
+    for (m = 0 ; m < FUZZ_MODES ; m++){
+        printf("%-8s worst call %8llu %s\n", _modeName[m],
+                (unsigned long long)_worst[m], FUZZ_UNIT);
+    }
+}
+
+#ifdef BUZZER_FUZZ_LIBFUZZER
+
+// read by libFuzzer as extra coverage counters, one per cost bucket
+__attribute__((used, section("__libfuzzer_extra_counters")))
+static uint8_t _costCounters[_BUCKETS];
+
+int LLVMFuzzerInitialize(int *argc, char ***argv){
+    (void)argc;
+    (void)argv;
+    _dir = getenv("BUZZER_FUZZ_DIR");
+    atexit(_report);
+
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size){
+    uint64_t cost = fuzz_measure(&_ctx, data, size, _RUNS);
+    fuzz_mode_e mode = (size > 0) ? (fuzz_mode_e)(data[0] % FUZZ_MODES) : FUZZ_MODE_ARRAY;
+
+    _costCounters[_bucket(cost)] = 1;
+    _save(data, size, mode, cost);
+
+    return 0;
+}
+
+#else
+
+typedef struct{
+    uint8_t data[_INPUT_MAX];
+    size_t size;
+}_input_t;
+
+static uint32_t _seed = 1;
+
+static uint32_t _rnd(uint32_t max){
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return _seed % max;
+}
+
+static void _mutate(_input_t *in){
+    uint32_t n = 1 + _rnd(4);
+    uint32_t p;
+
+    while (n--){
+        p = _rnd(in->size);
+        switch (_rnd(4)){
+        case 0:
+            in->data[p] ^= 1 << _rnd(8);
+            break;
+        case 1:
+            in->data[p] = _rnd(256);
+            break;
+        case 2:
+            in->data[p] += _rnd(16) - 8;
+            break;
+        default:
+            // the interesting values of the fields
+            in->data[p] = (uint8_t[]){0, 1, 0x7F, 0x80, 0xFF, 0x3F, 0x40, 0xC0}[_rnd(8)];
+            break;
+        }
+    }
+}
+
+/**
+ * search by mutation, keeping one input per cost bucket, as the
+ * libFuzzer counters do
+ */
+static void _search(uint32_t iterations){
+    static _input_t corpus[_BUCKETS];
+    _input_t in;
+    uint64_t cost;
+    uint32_t i, b, n = 0;
+    uint32_t used[_BUCKETS];
+
+    for (i = 0 ; i < iterations ; i++){
+        if (n == 0 || _rnd(8) == 0){
+            in.size = _INPUT_MAX;
+            for (b = 0 ; b < in.size ; b++){
+                in.data[b] = _rnd(256);
+            }
+        }
+        else{
+            in = corpus[used[_rnd(n)]];
+            _mutate(&in);
+        }
+        cost = fuzz_measure(&_ctx, in.data, in.size, _RUNS);
+        b = _bucket(cost);
+        if (corpus[b].size == 0){
+            used[n++] = b;
+        }
+        corpus[b] = in;
+        _save(in.data, in.size, (fuzz_mode_e)(in.data[0] % FUZZ_MODES), cost);
+    }
+}
+
+static int _replay(const char *path){
+    static uint8_t data[65536];
+    FILE *f = fopen(path, "rb");
+    size_t size;
+    uint64_t cost;
+
+    if (f == NULL){
+        fprintf(stderr, "can't open %s\n", path);
+        return 1;
+    }
+    size = fread(data, 1, sizeof(data), f);
+    fclose(f);
+    cost = fuzz_measure(&_ctx, data, size, _RUNS);
+    _save(data, size, (size > 0) ? (fuzz_mode_e)(data[0] % FUZZ_MODES) : FUZZ_MODE_ARRAY, cost);
+    printf("%-32s %8llu %s\n", path, (unsigned long long)cost, FUZZ_UNIT);
+
+    return 0;
+}
+
+int main(int argc, char **argv){
+    uint32_t iterations = 0;
+    int i, ret = 0;
+
+    for (i = 1 ; i < argc ; i++){
+        if (strcmp(argv[i], "-search") == 0 && i + 1 < argc){
+            iterations = strtoul(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc){
+            _seed = strtoul(argv[++i], NULL, 0);
+            _seed = (_seed != 0) ? _seed : 1;
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc){
+            _dir = argv[++i];
+        }
+        else{
+            ret |= _replay(argv[i]);
+        }
+    }
+    if (iterations > 0){
+        _search(iterations);
+    }
+    _report();
+
+    return ret;
+}
+
+#endif
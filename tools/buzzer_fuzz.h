@@ -0,0 +1,313 @@
+/*
+ * buzzer_fuzz.h
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Decodes a fuzzer input into a buzzer configuration and a playback
+ *  (array, melody with velocities, chords, sound effect, blink, Active
+ *  array, packed melody, pattern, burst or Morse text), and measures the
+ *  cost of each buzzer_interrupt() call. Shared by buzzer_fuzz.c, that
+ *  searches the worst inputs, and buzzer_bench.c, that replays them
+ *  against a bound. The modes that are not compiled in
+ *  (BUZZER_USE_xxx) play as a blink.
+ */
+
+#ifndef TOOLS_BUZZER_FUZZ_H_
+#define TOOLS_BUZZER_FUZZ_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "buzzer.h"
+
+#define FUZZ_MAX_LEN		64
+#define FUZZ_MAX_CALLS		4096
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define FUZZ_UNIT	"cycles"
+static inline uint64_t fuzz_now(void){
+    return __rdtsc();
+}
+#else
+#define FUZZ_UNIT	"ns"
+static inline uint64_t fuzz_now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+typedef enum{
+    FUZZ_MODE_ARRAY,
+    FUZZ_MODE_MELODY,
+    FUZZ_MODE_CHORDS,
+    FUZZ_MODE_SFX,
+    FUZZ_MODE_BLINK,
+    FUZZ_MODE_ACTIVE,
+    FUZZ_MODE_PACKED,
+    FUZZ_MODE_PATTERN,
+    FUZZ_MODE_BURST,
+    FUZZ_MODE_MORSE,
+    FUZZ_MODES
+}fuzz_mode_e;
+
+typedef struct{
+    buzzer_t buzzer;
+    buzzer_melody_t melody;
+    buzzer_envelope_t envelope;
+    buzzer_sfx_t sfx;
+    uint16_t times[FUZZ_MAX_LEN];
+    uint16_t freq[FUZZ_MAX_LEN];
+    uint8_t velocity[FUZZ_MAX_LEN];
+    buzzer_chord_t chords[FUZZ_MAX_LEN];
+    // raw bytes for the decoders, the packed notes and the Morse text
+    uint8_t packed[BUZZER_PACKED_HEADER_LEN + FUZZ_MAX_LEN * 2];
+    char text[FUZZ_MAX_LEN + 1];
+    buzzer_pattern_t pattern;
+    buzzer_burst_t burst;
+    buzzer_morse_t morse;
+    uint64_t cost[FUZZ_MAX_CALLS];
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+}fuzz_ctx_t;
+
+static void __fuzz_pwm_out(uint32_t freq){
+    (void)freq;
+}
+
+static void __fuzz_duty_out(uint32_t duty){
+    (void)duty;
+}
+
+static void __fuzz_gpio_out(uint32_t val){
+    (void)val;
+}
+
+// input bytes, 0 after the end
+static inline uint8_t __fuzz_u8(fuzz_ctx_t *ctx){
+    return (ctx->pos < ctx->size) ? ctx->data[ctx->pos++] : 0;
+}
+
+static inline uint16_t __fuzz_u16(fuzz_ctx_t *ctx){
+    uint16_t v = __fuzz_u8(ctx);
+
+    return v | ((uint16_t)__fuzz_u8(ctx) << 8);
+}
+
+/**
+ * @brief decode the input and start the playback, returns the mode
+ */
+static inline fuzz_mode_e fuzz_setup(fuzz_ctx_t *ctx, const uint8_t *data, size_t size){
+    fuzz_mode_e mode;
+    uint8_t flags;
+    uint16_t len, i, k;
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->data = data;
+    ctx->size = size;
+    mode = (fuzz_mode_e)(__fuzz_u8(ctx) % FUZZ_MODES);
+    flags = __fuzz_u8(ctx);
+    if (mode == FUZZ_MODE_ACTIVE){
+        ctx->buzzer.fnx.gpioOut = __fuzz_gpio_out;
+    }
+    else{
+        ctx->buzzer.fnx.pwmOut = __fuzz_pwm_out;
+        ctx->buzzer.fnx.pwmDutyOut = (flags & 0x08) ? __fuzz_duty_out : NULL;
+    }
+    ctx->buzzer.interruptMs = 1 + __fuzz_u8(ctx) % 10;
+    // the bytes are read without the effects too, an input decodes the
+    // same notes on every configuration
+#if BUZZER_USE_CHORDS
+    ctx->buzzer.arpeggioMs = __fuzz_u8(ctx);
+#else
+    __fuzz_u8(ctx);
+#endif
+#if BUZZER_USE_GLIDE
+    ctx->buzzer.glideMs = __fuzz_u16(ctx) % 4000;
+    ctx->buzzer.glideStepMs = __fuzz_u8(ctx) % 64;
+#else
+    __fuzz_u16(ctx);
+    __fuzz_u8(ctx);
+#endif
+#if BUZZER_USE_LFO
+    ctx->buzzer.lfoMs = __fuzz_u8(ctx) % 64;
+#else
+    __fuzz_u8(ctx);
+#endif
+    buzzer_init(&ctx->buzzer);
+
+#if BUZZER_USE_ENVELOPE
+    if (flags & 0x01){
+        ctx->envelope.attackMs = __fuzz_u16(ctx) % 2000;
+        ctx->envelope.decayMs = __fuzz_u16(ctx) % 2000;
+        ctx->envelope.releaseMs = __fuzz_u16(ctx) % 2000;
+        ctx->envelope.sustain = __fuzz_u8(ctx);
+        ctx->envelope.dutyMax = __fuzz_u8(ctx);
+        ctx->envelope.updateMs = __fuzz_u8(ctx) % 64;
+        buzzer_set_envelope(&ctx->buzzer, &ctx->envelope);
+    }
+#endif
+    // one read per statement, the order of the arguments is unspecified
+#if BUZZER_USE_LFO
+    if (flags & 0x02){
+        uint16_t rate = __fuzz_u16(ctx);
+        uint16_t depth = __fuzz_u16(ctx);
+        buzzer_set_vibrato(&ctx->buzzer, rate, depth, __fuzz_u8(ctx) % 3);
+    }
+    if (flags & 0x04){
+        uint16_t rate = __fuzz_u16(ctx);
+        uint8_t depth = __fuzz_u8(ctx);
+        buzzer_set_tremolo(&ctx->buzzer, rate, depth, __fuzz_u8(ctx) % 3);
+    }
+#endif
+#if BUZZER_USE_SOFTPWM
+    if ((flags & 0x10) && mode == FUZZ_MODE_ACTIVE){
+        buzzer_softpwm_init(&ctx->buzzer, 8000 + __fuzz_u16(ctx));
+        buzzer_set_volume(&ctx->buzzer, __fuzz_u8(ctx));
+    }
+#endif
+
+    len = 1 + __fuzz_u8(ctx) % FUZZ_MAX_LEN;
+    for (i = 0 ; i < len ; i++){
+        // short notes, so the edges dominate the run
+        ctx->times[i] = __fuzz_u8(ctx);
+        ctx->freq[i] = __fuzz_u16(ctx);
+        ctx->velocity[i] = __fuzz_u8(ctx);
+        if (mode == FUZZ_MODE_CHORDS){
+            for (k = 0 ; k < BUZZER_CHORD_MAX ; k++){
+                ctx->chords[i].freq[k] = __fuzz_u16(ctx) & BUZZER_FREQ_MASK;
+            }
+        }
+    }
+    ctx->melody.pTimes = ctx->times;
+    ctx->melody.pFreq = ctx->freq;
+    ctx->melody.pVelocity = (mode == FUZZ_MODE_MELODY) ? ctx->velocity : NULL;
+    ctx->melody.len = len;
+
+    switch (mode){
+    case FUZZ_MODE_MELODY:
+    case FUZZ_MODE_ARRAY:
+    case FUZZ_MODE_ACTIVE:
+        buzzer_start_melody(&ctx->buzzer, &ctx->melody);
+        break;
+#if BUZZER_USE_CHORDS
+    case FUZZ_MODE_CHORDS:
+        buzzer_start_chord_array(&ctx->buzzer, ctx->times, ctx->chords, len);
+        break;
+#endif
+#if BUZZER_USE_SFX
+    case FUZZ_MODE_SFX:
+        for (i = 0 ; i < sizeof(ctx->sfx) ; i++){
+            ((uint8_t*)&ctx->sfx)[i] = __fuzz_u8(ctx);
+        }
+        buzzer_start_sfx(&ctx->buzzer, &ctx->sfx);
+        break;
+#endif
+#if BUZZER_USE_PACKED
+    case FUZZ_MODE_PACKED:
+        // any byte, a note can be followed by a duration byte
+        ctx->packed[0] = __fuzz_u8(ctx);
+        ctx->packed[1] = __fuzz_u8(ctx) & 0x0F;
+        ctx->packed[2] = len;
+        ctx->packed[3] = 0;
+        for (i = 0 ; i < len * 2 ; i++){
+            ctx->packed[BUZZER_PACKED_HEADER_LEN + i] = __fuzz_u8(ctx);
+        }
+        buzzer_start_packed(&ctx->buzzer, ctx->packed);
+        break;
+#endif
+#if BUZZER_USE_PATTERN
+    case FUZZ_MODE_PATTERN:
+        ctx->pattern.mask = __fuzz_u16(ctx);
+        ctx->pattern.mask |= (uint32_t)__fuzz_u16(ctx) << 16;
+        ctx->pattern.freq = ctx->freq[0];
+        ctx->pattern.slotMs = ctx->times[0];
+        ctx->pattern.bits = __fuzz_u8(ctx);
+        buzzer_start_pattern(&ctx->buzzer, &ctx->pattern);
+        break;
+#endif
+#if BUZZER_USE_BURST
+    case FUZZ_MODE_BURST:
+        ctx->burst.freq = ctx->freq[0];
+        ctx->burst.onMs = ctx->times[0];
+        ctx->burst.offMs = __fuzz_u8(ctx);
+        ctx->burst.pauseMs = __fuzz_u8(ctx);
+        ctx->burst.pulses = __fuzz_u8(ctx);
+        ctx->burst.repeat = __fuzz_u8(ctx);
+        buzzer_start_burst(&ctx->buzzer, &ctx->burst);
+        break;
+#endif
+#if BUZZER_USE_MORSE
+    case FUZZ_MODE_MORSE:
+        // any char, the ones without a code are skipped
+        for (i = 0 ; i < len ; i++){
+            ctx->text[i] = (char)ctx->velocity[i];
+        }
+        ctx->text[len] = '\0';
+        ctx->morse.text = ctx->text;
+        ctx->morse.freq = ctx->freq[0];
+        ctx->morse.wpm = __fuzz_u8(ctx);
+        ctx->morse.farnsworthWpm = __fuzz_u8(ctx);
+        buzzer_start_morse(&ctx->buzzer, &ctx->morse);
+        break;
+#endif
+    default:
+        buzzer_start(&ctx->buzzer, ctx->freq[0], ctx->times[0], BUZZER_LOOP_ON);
+        break;
+    }
+
+    return mode;
+}
+
+/**
+ * @brief run the playback, up to FUZZ_MAX_CALLS interrupts, storing the
+ * cost of each call in ctx->cost. Returns the number of calls
+ */
+static inline uint32_t fuzz_run(fuzz_ctx_t *ctx){
+    uint64_t t0;
+    uint32_t n;
+
+    for (n = 0 ; n < FUZZ_MAX_CALLS && buzzer_is_active(&ctx->buzzer) ; n++){
+        t0 = fuzz_now();
+        buzzer_interrupt(&ctx->buzzer);
+#if BUZZER_USE_SOFTPWM
+        if (ctx->buzzer.softpwm.hz != 0){
+            buzzer_softpwm_interrupt(&ctx->buzzer);
+        }
+#endif
+        ctx->cost[n] = fuzz_now() - t0;
+    }
+    buzzer_stop(&ctx->buzzer);
+
+    return n;
+}
+
+/**
+ * @brief cost of the worst call of an input. The playback is the same on
+ * every run, so each call keeps its cheapest run, and a preemption of the
+ * host doesn't count as the cost of the input
+ */
+static inline uint64_t fuzz_measure(fuzz_ctx_t *ctx, const uint8_t *data, size_t size, uint32_t runs){
+    static uint64_t best[FUZZ_MAX_CALLS];
+    uint64_t worst = 0;
+    uint32_t n = 0, r, i;
+
+    for (r = 0 ; r < runs ; r++){
+        fuzz_setup(ctx, data, size);
+        n = fuzz_run(ctx);
+        for (i = 0 ; i < n ; i++){
+            best[i] = (r == 0 || ctx->cost[i] < best[i]) ? ctx->cost[i] : best[i];
+        }
+    }
+    for (i = 0 ; i < n ; i++){
+        worst = (best[i] > worst) ? best[i] : worst;
+    }
+
+    return worst;
+}
+
+#endif /* TOOLS_BUZZER_FUZZ_H_ */
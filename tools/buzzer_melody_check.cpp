@@ -0,0 +1,119 @@
+/*
+ * buzzer_melody_check.cpp
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Host check of the packed melodies of buzzer.hpp. The Super Mario theme
+ *  is written with BUZZER_MELODY(), played with buzzer_start_packed() and
+ *  its output edges are compared, tick by tick, with the ones of
+ *  mario_theme_melody and mario_theme_time on buzzer_start_array(). Also
+ *  prints the flash size of both forms.
+ *
+ *  build : gcc -O2 -I.. -c ../buzzer.c ../ringtones.c && \
+ *          g++ -std=c++17 -O2 -I.. -o buzzer_melody_check buzzer_melody_check.cpp \
+ *          buzzer.o ringtones.o
+ *  usage : buzzer_melody_check
+ *
+ *  exit 1 when the outputs differ. A malformed tune doesn't build, e.g.
+ *  BUZZER_MELODY("E9:8") stops on melody_error_pitch_out_of_range().
+ */
+
+#include <cstdio>
+
+#include "buzzer.hpp"
+
+#define _MAX_EDGES	256
+
+typedef struct{
+    uint32_t tick;
+    uint32_t freq;
+}edge_t;
+
+static edge_t _edges[_MAX_EDGES];
+static uint32_t _nEdges;
+static uint32_t _tick;
+
+static void _pwm_out(uint32_t freq){
+    if (_nEdges < _MAX_EDGES){
+        _edges[_nEdges].tick = _tick;
+        _edges[_nEdges].freq = freq;
+    }
+    _nEdges++;
+}
+
+static constexpr auto _mario = BUZZER_MELODY(
+        "T250 "
+        "E7:8 E7 R E7 | R C7 E7 R | G7 R R R | G6 R R R | "
+        "C7 R R G6 | R R E6 R | R A6 R B6 | R A#6 A6 R | "
+        "G6:16. E7 G7 | A7:8 R F7 G7 | R E7 R C7 | D7 B6 R R | "
+        "C7 R R G6 | R R E6 R | R A6 R B6 | R A#6 A6 R | "
+        "G6:16. E7 G7 | A7:8 R F7 G7 | R E7 R C7 | D7 B6 R R");
+
+#if __cplusplus >= 202002L
+using namespace buzzer::literals;
+static constexpr auto _scale = "T120 C4:4 D4 E4 F4 G4:2."_melody;
+static_assert(_scale.notes() == 5, "the literal has 5 notes");
+#endif
+
+static_assert(_mario.notes() == 78, "the theme has 78 notes");
+
+/**
+ * plays until the end, or the timeout, and returns the number of edges
+ */
+static uint32_t _record(buzzer_t *buzzer, edge_t *out){
+    uint32_t n;
+
+    for (n = 0 ; n < 60000 && buzzer->active ; n++){
+        _tick++;
+        buzzer_interrupt(buzzer);
+    }
+    n = (_nEdges < _MAX_EDGES) ? _nEdges : _MAX_EDGES;
+    for (uint32_t i = 0 ; i < n ; i++){
+        out[i] = _edges[i];
+    }
+    return _nEdges;
+}
+
+int main(void){
+    static edge_t arrayEdges[_MAX_EDGES], packedEdges[_MAX_EDGES];
+    buzzer_t buzzer = {};
+    uint32_t nArray, nPacked, i;
+
+    buzzer.fnx.pwmOut = _pwm_out;
+    buzzer.interruptMs = 1;
+    buzzer_init(&buzzer);
+
+    _nEdges = 0;
+    _tick = 0;
+    buzzer_start_array(&buzzer, mario_theme_time, mario_theme_melody, mario_theme_len);
+    nArray = _record(&buzzer, arrayEdges);
+
+    buzzer_invalidate_output(&buzzer);
+    _nEdges = 0;
+    _tick = 0;
+    buzzer_start_packed(&buzzer, _mario.data);
+    nPacked = _record(&buzzer, packedEdges);
+
+    printf("array  : %3u notes %4u bytes %4u edges\n", mario_theme_len,
+            (unsigned)(mario_theme_len * 2 * sizeof(uint16_t)), nArray);
+    printf("packed : %3u notes %4u bytes %4u edges\n", _mario.notes(),
+            (unsigned)_mario.size(), nPacked);
+
+    if (nArray != nPacked || nArray > _MAX_EDGES){
+        printf("FAIL, edge count differs\n");
+        return 1;
+    }
+    for (i = 0 ; i < nArray ; i++){
+        if (arrayEdges[i].tick != packedEdges[i].tick ||
+                arrayEdges[i].freq != packedEdges[i].freq){
+            printf("FAIL, edge %u: %u Hz at %u ms, expected %u Hz at %u ms\n", i,
+                    packedEdges[i].freq, packedEdges[i].tick,
+                    arrayEdges[i].freq, arrayEdges[i].tick);
+            return 1;
+        }
+    }
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * buzzer_pcm_render.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Host renderer of buzzer_pcm. Emulates the circular DMA and the PWM
+ *  carrier, writes what the buzzer receives (the mean of each carrier
+ *  period) to a WAV at the carrier rate, and verifies that the DMA
+ *  stream has exactly the source samples, followed only by silence.
+ *
+ *  build : gcc -O2 -I.. -o buzzer_pcm_render buzzer_pcm_render.c ../buzzer_pcm.c \
+ *          ../buzzer.c -lm
+ *  usage : buzzer_pcm_render [-r sample_rate] [-c carrier_hz] [-b buf_len]
+ *                            [in.raw] out.wav
+ *
+ *  in.raw has 8 bits unsigned samples, without it a "beep-boop" is
+ *  rendered.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "buzzer_pcm.h"
+#include "wav.h"
+
+static uint8_t *_dmaBuf;
+static uint32_t _dmaLen;
+static uint32_t _sampleRate;
+static int _running;
+
+static void _pcm_start(uint8_t *buf, uint32_t len, uint32_t sampleRate){
+    _dmaBuf = buf;
+    _dmaLen = len;
+    _sampleRate = sampleRate;
+    _running = 1;
+}
+
+static void _pcm_stop(void){
+    _running = 0;
+}
+
+static uint8_t *_beep_boop(uint32_t sampleRate, uint32_t *len){
+    uint32_t n = sampleRate * 3 / 10, i;
+    uint8_t *samples = malloc(n);
+
+    for (i = 0 ; i < n ; i++){
+        double f = (i < n / 2) ? 880.0 : 587.0;
+        double env = sin(M_PI * (i % (n / 2)) / (n / 2));
+        samples[i] = (uint8_t)(128 + 120 * env * sin(2 * M_PI * f * i / sampleRate));
+    }
+    *len = n;
+
+    return samples;
+}
+
+int main(int argc, char **argv){
+    buzzer_pcm_t pcm = {0};
+    uint32_t sampleRate = 16000, carrier = 62500, bufLen = 256;
+    uint32_t len, pos = 0, emitted = 0, mismatches = 0, tail = 0;
+    uint32_t acc = 0;
+    uint8_t *samples;
+    const char *in = NULL, *out = NULL;
+    int16_t wav[256];
+    uint32_t nWav = 0;
+    FILE *f;
+    int a;
+
+    for (a = 1 ; a < argc ; a++){
+        if (!strcmp(argv[a], "-r") && a + 1 < argc)
+            sampleRate = strtoul(argv[++a], NULL, 0);
+        else if (!strcmp(argv[a], "-c") && a + 1 < argc)
+            carrier = strtoul(argv[++a], NULL, 0);
+        else if (!strcmp(argv[a], "-b") && a + 1 < argc)
+            bufLen = strtoul(argv[++a], NULL, 0);
+        else if (in == NULL && a + 1 < argc)
+            in = argv[a];
+        else
+            out = argv[a];
+    }
+    if (out == NULL || carrier < sampleRate){
+        fprintf(stderr, "usage: %s [-r sample_rate] [-c carrier_hz] [-b buf_len] [in.raw] out.wav\n", argv[0]);
+        return 1;
+    }
+
+    if (in != NULL){
+        f = fopen(in, "rb");
+        if (f == NULL){
+            perror(in);
+            return 1;
+        }
+        fseek(f, 0, SEEK_END);
+        len = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        samples = malloc(len);
+        if (fread(samples, 1, len, f) != len){
+            fprintf(stderr, "failed to read %s\n", in);
+            return 1;
+        }
+        fclose(f);
+    }
+    else{
+        samples = _beep_boop(sampleRate, &len);
+    }
+
+    pcm.fnx.start = _pcm_start;
+    pcm.fnx.stop = _pcm_stop;
+    pcm.buf = malloc(bufLen);
+    pcm.bufLen = bufLen;
+    if (buzzer_pcm_init(&pcm) != BUZZER_ERR_OK){
+        fprintf(stderr, "invalid buffer length\n");
+        return 1;
+    }
+
+    f = wav_open(out, carrier);
+    if (f == NULL){
+        perror(out);
+        return 1;
+    }
+    buzzer_pcm_play_array(&pcm, samples, len, sampleRate);
+    while (_running){
+        // one DMA transfer, the compare value holds for carrier/sampleRate periods
+        uint8_t s = _dmaBuf[pos];
+
+        if (emitted < len){
+            mismatches += (s != samples[emitted]);
+        }
+        else{
+            tail++;
+            mismatches += (s != BUZZER_PCM_SILENCE);
+        }
+        emitted++;
+        acc += carrier;
+        while (acc >= sampleRate){
+            acc -= sampleRate;
+            wav[nWav++] = (int16_t)((s - 128) * 256);
+            if (nWav == sizeof(wav) / sizeof(wav[0])){
+                wav_write(f, wav, nWav);
+                nWav = 0;
+            }
+        }
+        pos++;
+        if (pos == _dmaLen / 2){
+            buzzer_pcm_half_transfer(&pcm);
+        }
+        else if (pos == _dmaLen){
+            pos = 0;
+            buzzer_pcm_transfer_complete(&pcm);
+        }
+    }
+    wav_write(f, wav, nWav);
+    wav_close(f);
+
+    printf("%u samples at %u Hz, carrier %u Hz, buffer %u\n", len, sampleRate, carrier, bufLen);
+    printf("%u transfers, %u silent tail, %u mismatches\n", emitted, tail, mismatches);
+    // the silent tail must be shorter than the double buffer
+    if (mismatches || emitted < len || tail > bufLen){
+        printf("FAILED\n");
+        return 1;
+    }
+    printf("OK\n");
+
+    free(samples);
+    free(pcm.buf);
+    return 0;
+}
@@ -0,0 +1,261 @@
+/*
+ * buzzer_render.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Offline renderer of the buzzer library. The outputs are implemented by
+ *  the square wave synthesizer of host_synth.h and buzzer_interrupt() is
+ *  called from a virtual clock, every interruptMs with an optional random
+ *  jitter, so any playback is rendered to a 16 bits WAV much faster than
+ *  real time, without flashing a board.
+ *
+ *  build : gcc -O2 -I.. -o buzzer_render buzzer_render.c ../buzzer.c ../ringtones.c
+ *  usage : buzzer_render [options] <tone freq ms | blink freq period ms | name | all dir>
+ *          options:
+ *            -o file   output WAV (default buzzer.wav)
+ *            -r rate   sample rate in Hz (default 44100)
+ *            -i ms     interruptMs (default 1)
+ *            -j us     max jitter of each interrupt, in us (default 0)
+ *            -t ms     max length of the render (default 60000)
+ *            -a        Active buzzer (gpioOut), instead of Passive
+ *            -b        band limited (PolyBLEP) output, for the high notes
+ *          names: mario, underworld, siren, chords, coin. "all" renders
+ *          every name to dir and prints the real time factor.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "buzzer.h"
+#include "ringtones.h"
+#include "host_synth.h"
+
+typedef void (*render_start_fx)(buzzer_t *buzzer);
+
+typedef struct{
+    const char *name;
+    render_start_fx start;
+}render_job_t;
+
+typedef struct{
+    uint32_t rate;
+    uint32_t interruptMs;
+    uint32_t jitterUs;
+    uint32_t maxMs;
+    uint8_t active;
+}render_cfg_t;
+
+static uint32_t _seed = 1;
+static uint32_t _elided;
+static uint16_t _toneFreq, _tonePeriod;
+static buzzer_loop_e _toneLoop;
+
+static uint16_t _sirenFreq[] = {800, BUZZER_GLIDE_LIN(1600), BUZZER_GLIDE_EXP(800)};
+static uint16_t _sirenTimes[] = {1, 1000, 1000};
+
+static buzzer_chord_t _chords[] = {
+    {{NOTE_C5, NOTE_E5, NOTE_G5, 0}},
+    {{NOTE_F5, NOTE_A5, NOTE_C6, 0}},
+    {{NOTE_G5, NOTE_B5, NOTE_D6, NOTE_F6}},
+    {{NOTE_C5, NOTE_E5, NOTE_G5, NOTE_C6}}
+};
+static uint16_t _chordTimes[] = {500, 500, 500, 1000};
+
+static const buzzer_sfx_t _coin = {
+    .baseFreq = 1000, .duty = 50, .arpMul = 21, .arpSteps = 10,
+    .sustain = 8, .decay = 30, .punch = 40, .stepMs = 5
+};
+
+static void _start_tone(buzzer_t *buzzer){
+    buzzer_start(buzzer, _toneFreq, _tonePeriod, _toneLoop);
+}
+
+static void _start_mario(buzzer_t *buzzer){
+    buzzer_start_array(buzzer, mario_theme_time, mario_theme_melody, mario_theme_len);
+}
+
+static void _start_underworld(buzzer_t *buzzer){
+    buzzer_start_array(buzzer, underworld_time, underworld_melody, underworld_len);
+}
+
+static void _start_siren(buzzer_t *buzzer){
+    buzzer_start_array(buzzer, _sirenTimes, _sirenFreq, 3);
+}
+
+static void _start_chords(buzzer_t *buzzer){
+    buzzer_start_chord_array(buzzer, _chordTimes, _chords, sizeof(_chordTimes) / sizeof(_chordTimes[0]));
+}
+
+static void _start_coin(buzzer_t *buzzer){
+    buzzer_start_sfx(buzzer, &_coin);
+}
+
+static const render_job_t _jobs[] = {
+    {"mario", _start_mario},
+    {"underworld", _start_underworld},
+    {"siren", _start_siren},
+    {"chords", _start_chords},
+    {"coin", _start_coin},
+};
+
+#define _JOBS	(sizeof(_jobs) / sizeof(_jobs[0]))
+
+static int32_t _jitter(uint32_t max){
+    if (max == 0){
+        return 0;
+    }
+    _seed ^= _seed << 13;
+    _seed ^= _seed >> 17;
+    _seed ^= _seed << 5;
+    return (int32_t)(_seed % (2 * max + 1)) - (int32_t)max;
+}
+
+static double _now_ms(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/**
+ * render one playback, returns the rendered length in ms or -1
+ */
+static int32_t _render(const render_cfg_t *cfg, render_start_fx start, const char *path){
+    buzzer_t buzzer = {0};
+    uint64_t us = 0;
+    int32_t dt;
+
+    if (host_synth_open(path, cfg->rate) != 0){
+        fprintf(stderr, "can't create %s\n", path);
+        return -1;
+    }
+    if (cfg->active){
+        buzzer.fnx.gpioOut = host_synth_gpio_out;
+    }
+    else{
+        buzzer.fnx.pwmOut = host_synth_pwm_out;
+        buzzer.fnx.pwmDutyOut = host_synth_duty_out;
+    }
+    buzzer.interruptMs = cfg->interruptMs;
+#if BUZZER_USE_CHORDS
+    buzzer.arpeggioMs = 20;
+#endif
+#if BUZZER_USE_GLIDE
+    buzzer.glideStepMs = 5;
+#endif
+    buzzer_init(&buzzer);
+    start(&buzzer);
+    while (buzzer_is_active(&buzzer) && us < (uint64_t)cfg->maxMs * 1000){
+        dt = (int32_t)(cfg->interruptMs * 1000) + _jitter(cfg->jitterUs);
+        dt = (dt > 0) ? dt : 0;
+        host_synth_render_us(dt);
+        us += dt;
+        buzzer_interrupt(&buzzer);
+    }
+    buzzer_stop(&buzzer);
+    _elided = buzzer_get_elided_writes(&buzzer);
+    // a short tail, so the last note isn't cut by the players
+    host_synth_render_us(50000);
+    host_synth_close();
+
+    return (int32_t)(us / 1000);
+}
+
+static int _render_all(const render_cfg_t *cfg, const char *dir){
+    char path[512];
+    double t0, elapsed;
+    int64_t totalMs = 0;
+    int32_t ms;
+    uint32_t i;
+
+    t0 = _now_ms();
+    for (i = 0 ; i < _JOBS ; i++){
+        snprintf(path, sizeof(path), "%s/%s.wav", dir, _jobs[i].name);
+        ms = _render(cfg, _jobs[i].start, path);
+        if (ms < 0){
+            return 1;
+        }
+        printf("%-12s %8d ms %6u writes %6u elided -> %s\n", _jobs[i].name, ms,
+                hostSynth.writes, _elided, path);
+        totalMs += ms;
+    }
+    elapsed = _now_ms() - t0;
+    printf("%lld ms of audio in %.2f ms, %.0fx real time\n", (long long)totalMs,
+            elapsed, elapsed > 0 ? totalMs / elapsed : 0.0);
+
+    return 0;
+}
+
+int main(int argc, char **argv){
+    render_cfg_t cfg = {.rate = 44100, .interruptMs = 1, .jitterUs = 0, .maxMs = 60000, .active = 0};
+    const char *out = "buzzer.wav";
+    render_start_fx start = NULL;
+    double t0;
+    int32_t ms;
+    int i;
+    uint32_t j;
+
+    for (i = 1 ; i < argc && argv[i][0] == '-' ; i++){
+        if (strcmp(argv[i], "-a") == 0){
+            cfg.active = 1;
+        }
+        else if (strcmp(argv[i], "-b") == 0){
+            hostSynth.blep = 1;
+        }
+        else if (i + 1 < argc){
+            switch (argv[i][1]){
+            case 'o': out = argv[++i]; break;
+            case 'r': cfg.rate = strtoul(argv[++i], NULL, 0); break;
+            case 'i': cfg.interruptMs = strtoul(argv[++i], NULL, 0); break;
+            case 'j': cfg.jitterUs = strtoul(argv[++i], NULL, 0); break;
+            case 't': cfg.maxMs = strtoul(argv[++i], NULL, 0); break;
+            default: i = argc; break;
+            }
+        }
+    }
+    if (i >= argc || cfg.rate == 0 || cfg.interruptMs == 0){
+        fprintf(stderr, "usage: %s [-o file] [-r rate] [-i ms] [-j us] [-t ms] [-a] [-b]\n"
+                "       <tone freq ms | blink freq period ms | name | all dir>\n", argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[i], "all") == 0 && i + 1 < argc){
+        return _render_all(&cfg, argv[i + 1]);
+    }
+    if (strcmp(argv[i], "tone") == 0 && i + 2 < argc){
+        _toneFreq = strtoul(argv[i + 1], NULL, 0);
+        _tonePeriod = strtoul(argv[i + 2], NULL, 0);
+        _toneLoop = BUZZER_LOOP_OFF;
+        start = _start_tone;
+    }
+    else if (strcmp(argv[i], "blink") == 0 && i + 3 < argc){
+        _toneFreq = strtoul(argv[i + 1], NULL, 0);
+        _tonePeriod = strtoul(argv[i + 2], NULL, 0);
+        _toneLoop = BUZZER_LOOP_ON;
+        cfg.maxMs = strtoul(argv[i + 3], NULL, 0);
+        start = _start_tone;
+    }
+    else{
+        for (j = 0 ; j < _JOBS ; j++){
+            if (strcmp(argv[i], _jobs[j].name) == 0){
+                start = _jobs[j].start;
+            }
+        }
+    }
+    if (start == NULL){
+        fprintf(stderr, "unknown playback %s\n", argv[i]);
+        return 1;
+    }
+
+    t0 = _now_ms();
+    ms = _render(&cfg, start, out);
+    if (ms < 0){
+        return 1;
+    }
+    printf("%d ms rendered to %s in %.2f ms, %u writes, %u elided\n", ms, out,
+            _now_ms() - t0, hostSynth.writes, _elided);
+
+    return 0;
+}
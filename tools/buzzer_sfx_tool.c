@@ -0,0 +1,190 @@
+/*
+ * buzzer_sfx_tool.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Host tool for the procedural sound effects (buzzer_start_sfx). Renders
+ *  a preset, or a random effect of a category, to a WAV through the real
+ *  buzzer_interrupt(), and prints the parameters as a C initializer, ready
+ *  to paste in the firmware.
+ *
+ *  Build (from this folder):
+ *      gcc -O2 -I.. -o buzzer_sfx_tool buzzer_sfx_tool.c ../buzzer.c
+ *  Use:
+ *      ./buzzer_sfx_tool <coin|laser|powerup|hit|jump|blip> [-r] [-s seed] [-o out.wav]
+ *
+ *  -r randomizes the category (seed 1 by default), otherwise the preset
+ *  is rendered as it is.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buzzer.h"
+#include "host_synth.h"
+
+#define SFX_RATE		44100
+#define SFX_MAX_MS		10000
+
+typedef struct{
+    const char *name;
+    buzzer_sfx_t preset;
+}sfx_category_t;
+
+static const sfx_category_t categories[] = {
+    {"coin",    {.baseFreq = 1000, .slide = 0, .duty = 50, .arpMul = 21, .arpSteps = 10,
+                 .attack = 0, .sustain = 8, .decay = 30, .punch = 40, .stepMs = 5}},
+    {"laser",   {.baseFreq = 2400, .slide = -160, .deltaSlide = 2, .minFreq = 20, .duty = 30,
+                 .dutySweep = 4, .attack = 0, .sustain = 10, .decay = 20, .stepMs = 5}},
+    {"powerup", {.baseFreq = 400, .slide = 40, .duty = 40, .repeatSteps = 24,
+                 .attack = 0, .sustain = 40, .decay = 30, .stepMs = 5}},
+    {"hit",     {.baseFreq = 600, .slide = -120, .minFreq = 5, .duty = 50, .dutySweep = -8,
+                 .attack = 0, .sustain = 4, .decay = 16, .punch = 60, .stepMs = 5}},
+    {"jump",    {.baseFreq = 500, .slide = 60, .deltaSlide = -1, .duty = 40,
+                 .attack = 0, .sustain = 16, .decay = 24, .stepMs = 5}},
+    {"blip",    {.baseFreq = 1500, .duty = 50, .attack = 0, .sustain = 6, .decay = 4, .stepMs = 5}},
+};
+
+static uint32_t seed = 1;
+
+static int32_t rnd(int32_t min, int32_t max){
+    // xorshift32, same sequence on every host
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return min + (int32_t)(seed % (uint32_t)(max - min + 1));
+}
+
+static void randomize(const char *name, buzzer_sfx_t *p){
+    memset(p, 0, sizeof(*p));
+    p->stepMs = 5;
+    p->duty = rnd(0, 1) ? 50 : rnd(10, 50);
+    if (strcmp(name, "coin") == 0){
+        p->baseFreq = rnd(700, 1800);
+        p->arpMul = rnd(18, 32);
+        p->arpSteps = rnd(4, 14);
+        p->sustain = rnd(4, 12);
+        p->decay = rnd(15, 50);
+        p->punch = rnd(20, 70);
+    }
+    else if (strcmp(name, "laser") == 0){
+        p->baseFreq = rnd(1200, 4000);
+        p->slide = -rnd(60, 300);
+        p->deltaSlide = rnd(0, 4);
+        p->minFreq = rnd(10, 40);
+        p->duty = rnd(10, 50);
+        p->dutySweep = rnd(-8, 8);
+        p->sustain = rnd(6, 20);
+        p->decay = rnd(10, 40);
+    }
+    else if (strcmp(name, "powerup") == 0){
+        p->baseFreq = rnd(250, 800);
+        p->slide = rnd(20, 100);
+        p->repeatSteps = rnd(0, 1) ? rnd(12, 40) : 0;
+        p->sustain = rnd(20, 60);
+        p->decay = rnd(20, 50);
+    }
+    else if (strcmp(name, "hit") == 0){
+        p->baseFreq = rnd(300, 1200);
+        p->slide = -rnd(40, 200);
+        p->minFreq = 5;
+        p->dutySweep = -rnd(0, 12);
+        p->sustain = rnd(2, 8);
+        p->decay = rnd(8, 25);
+        p->punch = rnd(0, 80);
+    }
+    else if (strcmp(name, "jump") == 0){
+        p->baseFreq = rnd(300, 900);
+        p->slide = rnd(30, 120);
+        p->deltaSlide = -rnd(0, 3);
+        p->sustain = rnd(8, 24);
+        p->decay = rnd(10, 40);
+    }
+    else{
+        p->baseFreq = rnd(400, 3000);
+        p->sustain = rnd(2, 10);
+        p->decay = rnd(2, 10);
+    }
+}
+
+static void print_blob(const char *name, const buzzer_sfx_t *p){
+    const uint8_t *b = (const uint8_t*)p;
+    uint32_t i;
+
+    printf("const buzzer_sfx_t sfx_%s = {\n", name);
+    printf("    .baseFreq = %u, .slide = %d, .deltaSlide = %d, .minFreq = %u,\n",
+            p->baseFreq, p->slide, p->deltaSlide, p->minFreq);
+    printf("    .duty = %u, .dutySweep = %d, .arpMul = %u, .arpSteps = %u,\n",
+            p->duty, p->dutySweep, p->arpMul, p->arpSteps);
+    printf("    .repeatSteps = %u, .attack = %u, .sustain = %u, .decay = %u,\n",
+            p->repeatSteps, p->attack, p->sustain, p->decay);
+    printf("    .punch = %u, .stepMs = %u\n};\n", p->punch, p->stepMs);
+    printf("// %u bytes:", (unsigned)sizeof(*p));
+    for (i = 0 ; i < sizeof(*p) ; i++){
+        printf(" %02X", b[i]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv){
+    const sfx_category_t *cat = NULL;
+    const char *out = "sfx.wav";
+    buzzer_sfx_t sfx;
+    buzzer_t buzzer = {0};
+    int random = 0;
+    uint32_t ms;
+    uint32_t i;
+
+    if (argc < 2){
+        fprintf(stderr, "use: %s <coin|laser|powerup|hit|jump|blip> [-r] [-s seed] [-o out.wav]\n", argv[0]);
+        return 1;
+    }
+    for (i = 0 ; i < sizeof(categories)/sizeof(categories[0]) ; i++){
+        if (strcmp(argv[1], categories[i].name) == 0){
+            cat = &categories[i];
+        }
+    }
+    if (cat == NULL){
+        fprintf(stderr, "unknown category %s\n", argv[1]);
+        return 1;
+    }
+    for (i = 2 ; i < (uint32_t)argc ; i++){
+        if (strcmp(argv[i], "-r") == 0){
+            random = 1;
+        }
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < (uint32_t)argc){
+            seed = strtoul(argv[++i], NULL, 0);
+            seed = (seed != 0) ? seed : 1;
+            random = 1;
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < (uint32_t)argc){
+            out = argv[++i];
+        }
+    }
+    sfx = cat->preset;
+    if (random){
+        randomize(cat->name, &sfx);
+    }
+    print_blob(cat->name, &sfx);
+
+    if (host_synth_open(out, SFX_RATE) != 0){
+        fprintf(stderr, "can't create %s\n", out);
+        return 1;
+    }
+    buzzer.fnx.pwmOut = host_synth_pwm_out;
+    buzzer.fnx.pwmDutyOut = host_synth_duty_out;
+    buzzer.interruptMs = 1;
+    buzzer_init(&buzzer);
+    buzzer_start_sfx(&buzzer, &sfx);
+    for (ms = 0 ; ms < SFX_MAX_MS && buzzer_is_active(&buzzer) ; ms++){
+        host_synth_render_us(1000);
+        buzzer_interrupt(&buzzer);
+    }
+    host_synth_render_us(20000);
+    host_synth_close();
+    printf("// %ums rendered to %s\n", ms, out);
+
+    return 0;
+}
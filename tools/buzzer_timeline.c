@@ -0,0 +1,229 @@
+/*
+ * buzzer_timeline.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Output timelines of the playbacks, for timing regressions. Every
+ *  ringtone of ringtones.c and every buzzer_start() loop mode is played
+ *  through a simulated clock, and each output edge is recorded as
+ *  "ms value" (frequency, or GPIO level on Active buzzers). "record" saves
+ *  the timelines of a known good revision, "check" compares the current
+ *  one against them, reporting the error of each note and the cumulative
+ *  drift, and fails (exit 1) out of the tolerances.
+ *
+ *  build : gcc -O2 -I.. -o buzzer_timeline buzzer_timeline.c ../buzzer.c ../ringtones.c
+ *  usage : buzzer_timeline record dir [-i ms]
+ *          buzzer_timeline check dir [-i ms] [-n note_tol_ms] [-d drift_tol_ms]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buzzer.h"
+#include "ringtones.h"
+
+#define _MAX_EDGES		4096
+#define _MAX_MS			60000
+
+typedef struct{
+    uint32_t ms;
+    uint32_t value;
+}_edge_t;
+
+typedef struct{
+    _edge_t edge[_MAX_EDGES];
+    uint32_t len;
+}_timeline_t;
+
+typedef struct{
+    const char *name;
+    uint8_t active;
+    void (*start)(buzzer_t *buzzer);
+    uint32_t stopMs;    // buzzer_stop() at, 0 plays to the end
+}_case_t;
+
+static _timeline_t _tl;
+static uint32_t _ms;
+
+static void _record(uint32_t value){
+    if (_tl.len < _MAX_EDGES){
+        _tl.edge[_tl.len].ms = _ms;
+        _tl.edge[_tl.len].value = value;
+        _tl.len++;
+    }
+}
+
+static void _start_mario(buzzer_t *buzzer){
+    buzzer_start_array(buzzer, mario_theme_time, mario_theme_melody, mario_theme_len);
+}
+
+static void _start_underworld(buzzer_t *buzzer){
+    buzzer_start_array(buzzer, underworld_time, underworld_melody, underworld_len);
+}
+
+static void _start_once(buzzer_t *buzzer){
+    buzzer_start(buzzer, 1000, 500, BUZZER_LOOP_OFF);
+}
+
+static void _start_loop(buzzer_t *buzzer){
+    buzzer_start(buzzer, 800, 250, BUZZER_LOOP_ON);
+}
+
+static void _start_on(buzzer_t *buzzer){
+    buzzer_turn_on(buzzer, 1500);
+}
+
+static const _case_t _cases[] = {
+    {"mario", 0, _start_mario, 0},
+    {"underworld", 0, _start_underworld, 0},
+    {"loop_off", 0, _start_once, 0},
+    {"loop_on", 0, _start_loop, 3000},
+    {"turn_on", 0, _start_on, 700},
+    {"active_mario", 1, _start_mario, 0},
+    {"active_loop_off", 1, _start_once, 0},
+    {"active_loop_on", 1, _start_loop, 3000},
+};
+
+#define _CASES	(sizeof(_cases) / sizeof(_cases[0]))
+
+static void _play(const _case_t *c, uint32_t interruptMs){
+    buzzer_t buzzer = {0};
+
+    _tl.len = 0;
+    _ms = 0;
+    if (c->active){
+        buzzer.fnx.gpioOut = _record;
+    }
+    else{
+        buzzer.fnx.pwmOut = _record;
+    }
+    buzzer.interruptMs = interruptMs;
+    buzzer_init(&buzzer);
+    // the edge of the init isn't part of the playback
+    _tl.len = 0;
+    c->start(&buzzer);
+    while (buzzer_is_active(&buzzer) && _ms < _MAX_MS){
+        _ms += interruptMs;
+        if (c->stopMs != 0 && _ms >= c->stopMs){
+            buzzer_stop(&buzzer);
+            break;
+        }
+        buzzer_interrupt(&buzzer);
+    }
+}
+
+static int _save(const char *path){
+    FILE *f = fopen(path, "w");
+    uint32_t i;
+
+    if (f == NULL){
+        return -1;
+    }
+    for (i = 0 ; i < _tl.len ; i++){
+        fprintf(f, "%u %u\n", _tl.edge[i].ms, _tl.edge[i].value);
+    }
+    fclose(f);
+
+    return 0;
+}
+
+static int _load(const char *path, _timeline_t *tl){
+    FILE *f = fopen(path, "r");
+
+    if (f == NULL){
+        return -1;
+    }
+    tl->len = 0;
+    while (tl->len < _MAX_EDGES &&
+            fscanf(f, "%u %u", &tl->edge[tl->len].ms, &tl->edge[tl->len].value) == 2){
+        tl->len++;
+    }
+    fclose(f);
+
+    return 0;
+}
+
+/**
+ * compare with the golden timeline, the error of a note is the error of
+ * its duration, the drift is the error of the edge time
+ */
+static int _compare(const char *name, const _timeline_t *golden, uint32_t noteTol, uint32_t driftTol){
+    int32_t note, drift = 0, maxNote = 0, maxDrift = 0;
+    uint32_t i, len = (golden->len < _tl.len) ? golden->len : _tl.len;
+    uint32_t wrong = 0;
+    int fail;
+
+    for (i = 0 ; i < len ; i++){
+        if (golden->edge[i].value != _tl.edge[i].value){
+            if (wrong++ == 0){
+                printf("  %s: edge %u is %u, expected %u\n", name, i,
+                        _tl.edge[i].value, golden->edge[i].value);
+            }
+        }
+        drift = (int32_t)(_tl.edge[i].ms - golden->edge[i].ms);
+        note = (i == 0) ? drift : drift - (int32_t)(_tl.edge[i - 1].ms - golden->edge[i - 1].ms);
+        maxNote = (abs(note) > abs(maxNote)) ? note : maxNote;
+        maxDrift = (abs(drift) > abs(maxDrift)) ? drift : maxDrift;
+    }
+    fail = (golden->len != _tl.len) || wrong ||
+            (uint32_t)abs(maxNote) > noteTol || (uint32_t)abs(maxDrift) > driftTol;
+    printf("%-16s %4u edges (golden %4u) %3u wrong  note err %+5d ms  drift %+5d ms (end %+d)  %s\n",
+            name, _tl.len, golden->len, wrong, maxNote, maxDrift, drift, fail ? "FAIL" : "ok");
+
+    return fail;
+}
+
+int main(int argc, char **argv){
+    static _timeline_t golden;
+    uint32_t interruptMs = 1, noteTol = 0, driftTol = 0;
+    char path[512];
+    int record, fails = 0;
+    uint32_t i;
+
+    if (argc < 3 || (strcmp(argv[1], "record") != 0 && strcmp(argv[1], "check") != 0)){
+        fprintf(stderr, "usage: %s record dir [-i ms]\n"
+                "       %s check dir [-i ms] [-n note_tol_ms] [-d drift_tol_ms]\n", argv[0], argv[0]);
+        return 1;
+    }
+    record = (strcmp(argv[1], "record") == 0);
+    for (i = 3 ; i + 1 < (uint32_t)argc ; i += 2){
+        if (strcmp(argv[i], "-i") == 0){
+            interruptMs = strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-n") == 0){
+            noteTol = strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-d") == 0){
+            driftTol = strtoul(argv[i + 1], NULL, 0);
+        }
+    }
+    if (interruptMs == 0){
+        return 1;
+    }
+
+    for (i = 0 ; i < _CASES ; i++){
+        snprintf(path, sizeof(path), "%s/%s.txt", argv[2], _cases[i].name);
+        _play(&_cases[i], interruptMs);
+        if (record){
+            if (_save(path) != 0){
+                fprintf(stderr, "can't write %s\n", path);
+                return 1;
+            }
+            printf("%-16s %4u edges -> %s\n", _cases[i].name, _tl.len, path);
+        }
+        else if (_load(path, &golden) != 0){
+            printf("%-16s no golden timeline %s  FAIL\n", _cases[i].name, path);
+            fails++;
+        }
+        else{
+            fails += _compare(_cases[i].name, &golden, noteTol, driftTol);
+        }
+    }
+    if (!record){
+        printf("%d of %u timelines failed\n", fails, (unsigned)_CASES);
+    }
+
+    return (fails > 0);
+}
@@ -0,0 +1,125 @@
+/*
+ * buzzer_trace_decode.c
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Host tool, converts a RAM dump that contains the buzzer_trace buffer
+ *  (see buzzer_trace.h) to a readable timeline. The dump can be the
+ *  buffer alone or the whole RAM, the buffer is found by its magic.
+ *
+ *  build : gcc -O2 -I.. -o buzzer_trace_decode buzzer_trace_decode.c
+ *  usage : buzzer_trace_decode <dump.bin> [timestamp_hz]
+ *
+ *  With timestamp_hz (e.g. the core clock when the timestamp is the
+ *  DWT cycle counter), the time is printed in milliseconds.
+ *  The dump must come from a little endian target.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "buzzer_trace.h"
+
+static const char *_evNames[] = {
+    "?",
+    "START",
+    "STOP",
+    "NOTE",
+    "PREEMPT",
+    "CALLBACK"
+};
+
+static uint32_t _rd32(const uint8_t *p){
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint16_t _rd16(const uint8_t *p){
+    return p[0] | (p[1] << 8);
+}
+
+static long _find_buffer(const uint8_t *data, long size){
+    long off;
+    uint16_t len, recSize;
+
+    for (off = 0 ; off + 12 <= size ; off += 4){
+        if (_rd32(&data[off]) != BUZZER_TRACE_MAGIC)
+            continue;
+        len = _rd16(&data[off + 4]);
+        recSize = _rd16(&data[off + 6]);
+        if (len == 0 || (len & (len - 1)) != 0 ||
+                recSize != sizeof(buzzer_trace_rec_t))
+            continue;
+        if (off + 12 + (long)len * recSize > size)
+            continue;
+        return off;
+    }
+
+    return -1;
+}
+
+int main(int argc, char **argv){
+    FILE *f;
+    uint8_t *data;
+    long size, off;
+    uint32_t head, first, n, i, prev = 0;
+    uint16_t len;
+    double hz = 0;
+
+    if (argc < 2){
+        fprintf(stderr, "usage: %s <dump.bin> [timestamp_hz]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2)
+        hz = atof(argv[2]);
+
+    f = fopen(argv[1], "rb");
+    if (f == NULL){
+        perror(argv[1]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data = malloc(size);
+    if (data == NULL || fread(data, 1, size, f) != (size_t)size){
+        fprintf(stderr, "failed to read %s\n", argv[1]);
+        return 1;
+    }
+    fclose(f);
+
+    off = _find_buffer(data, size);
+    if (off < 0){
+        fprintf(stderr, "trace buffer not found\n");
+        return 1;
+    }
+    len = _rd16(&data[off + 4]);
+    head = _rd32(&data[off + 8]);
+    n = head < len ? head : len;
+    first = head - n;
+
+    printf("buffer at 0x%lx, %u records, %u pushed, %u lost\n",
+            off, len, head, first);
+    printf("%10s %14s %10s %5s %-9s %6s\n",
+            "seq", "time", "delta", "inst", "event", "freq");
+    for (i = first ; i < head ; i++){
+        const uint8_t *rec = &data[off + 12 + (i & (len - 1)) * sizeof(buzzer_trace_rec_t)];
+        uint32_t ts = _rd32(&rec[0]);
+        uint16_t freq = _rd16(&rec[4]);
+        uint8_t inst = rec[6];
+        uint8_t ev = rec[7];
+        uint32_t delta = (i == first) ? 0 : ts - prev;
+
+        if (hz > 0)
+            printf("%10u %14.3f %10.3f ", i, ts * 1000.0 / hz, delta * 1000.0 / hz);
+        else
+            printf("%10u %14u %10u ", i, ts, delta);
+        printf("%5u %-9s %6u\n", inst,
+                ev < sizeof(_evNames) / sizeof(_evNames[0]) ? _evNames[ev] : "?", freq);
+        prev = ts;
+    }
+
+    free(data);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * host_synth.h
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Host output of the buzzer library, the pwmOut, pwmDutyOut and gpioOut
+ *  functions drive a square wave synthesizer that is rendered to a WAV,
+ *  used by the host tools. The caller advances the virtual clock with
+ *  host_synth_render_us() between the buzzer_interrupt() calls.
+ */
+
+#ifndef TOOLS_HOST_SYNTH_H_
+#define TOOLS_HOST_SYNTH_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "wav.h"
+#include "blep.h"
+
+#define HOST_SYNTH_AMPLITUDE	12000
+#define HOST_SYNTH_ACTIVE_HZ	2400
+#define HOST_SYNTH_BLOCK		1024
+
+typedef struct{
+    uint32_t rate;
+    uint32_t freq;
+    uint32_t duty;
+    uint32_t gpio;
+    uint32_t activeHz;
+    uint8_t blep;           // band limited output (PolyBLEP), set before open
+    uint32_t phase;
+    float blepPhase;
+    uint64_t frac;
+    uint64_t samples;
+    uint32_t writes;
+    FILE *wav;
+    int16_t block[HOST_SYNTH_BLOCK];
+    uint32_t nBlock;
+}host_synth_t;
+
+static host_synth_t hostSynth;
+
+static inline void host_synth_pwm_out(uint32_t freq){
+    hostSynth.freq = freq;
+    hostSynth.writes++;
+}
+
+static inline void host_synth_duty_out(uint32_t duty){
+    hostSynth.duty = duty;
+    hostSynth.writes++;
+}
+
+static inline void host_synth_gpio_out(uint32_t val){
+    hostSynth.gpio = val;
+    hostSynth.writes++;
+}
+
+/**
+ * @brief start the synthesizer, path can be NULL to only advance the
+ * clock (e.g. when timing)
+ */
+static inline int host_synth_open(const char *path, uint32_t rate){
+    hostSynth.rate = rate;
+    hostSynth.freq = 0;
+    hostSynth.duty = 50;
+    hostSynth.gpio = 0;
+    hostSynth.phase = 0;
+    hostSynth.blepPhase = 0;
+    hostSynth.frac = 0;
+    hostSynth.samples = 0;
+    hostSynth.writes = 0;
+    hostSynth.nBlock = 0;
+    if (hostSynth.activeHz == 0){
+        hostSynth.activeHz = HOST_SYNTH_ACTIVE_HZ;
+    }
+    hostSynth.wav = NULL;
+    if (path != NULL){
+        hostSynth.wav = wav_open(path, rate);
+        if (hostSynth.wav == NULL){
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief render the current output for us microseconds, the fraction of
+ * sample is kept for the next call, so the clock never drifts
+ */
+static inline void host_synth_render_us(uint32_t us){
+    uint32_t freq = hostSynth.gpio ? hostSynth.activeHz : hostSynth.freq;
+    uint32_t duty = hostSynth.gpio ? 50 : hostSynth.duty;
+    // phase and duty in Q32, the output has no DC
+    uint32_t inc = (uint32_t)(((uint64_t)freq << 32) / hostSynth.rate);
+    uint32_t high = (uint32_t)(((uint64_t)duty << 32) / 100);
+    int32_t hi = (int32_t)(((uint64_t)(100 - duty) * 2 * HOST_SYNTH_AMPLITUDE) / 100);
+    int32_t lo = hi - 2 * HOST_SYNTH_AMPLITUDE;
+    uint64_t n;
+
+    hostSynth.frac += (uint64_t)us * hostSynth.rate;
+    n = hostSynth.frac / 1000000;
+    hostSynth.frac -= n * 1000000;
+    hostSynth.samples += n;
+    if (hostSynth.wav == NULL){
+        return;
+    }
+    if (freq == 0 || duty == 0){
+        hi = lo = 0;
+    }
+    else if (hostSynth.blep && freq * 2 < hostSynth.rate){
+        float dt = (float)freq / hostSynth.rate;
+        float d = (float)duty / 100.0f;
+
+        while (n--){
+            hostSynth.block[hostSynth.nBlock++] = (int16_t)(HOST_SYNTH_AMPLITUDE *
+                    blep_sample(&hostSynth.blepPhase, dt, 1.0f / dt, d));
+            if (hostSynth.nBlock == HOST_SYNTH_BLOCK){
+                wav_write(hostSynth.wav, hostSynth.block, hostSynth.nBlock);
+                hostSynth.nBlock = 0;
+            }
+        }
+        return;
+    }
+    while (n--){
+        hostSynth.block[hostSynth.nBlock++] = (hostSynth.phase < high) ? hi : lo;
+        hostSynth.phase += inc;
+        if (hostSynth.nBlock == HOST_SYNTH_BLOCK){
+            wav_write(hostSynth.wav, hostSynth.block, hostSynth.nBlock);
+            hostSynth.nBlock = 0;
+        }
+    }
+}
+
+static inline void host_synth_close(void){
+    if (hostSynth.wav != NULL){
+        wav_write(hostSynth.wav, hostSynth.block, hostSynth.nBlock);
+        wav_close(hostSynth.wav);
+        hostSynth.wav = NULL;
+    }
+}
+
+#endif /* TOOLS_HOST_SYNTH_H_ */
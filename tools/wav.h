@@ -0,0 +1,70 @@
+/*
+ * wav.h
+ *
+ *  Created on: 19 de out de 2026
+ *      Author: pablo.jean
+ *
+ *  Minimal 16 bits mono WAV writer, used by the host tools
+ */
+
+#ifndef TOOLS_WAV_H_
+#define TOOLS_WAV_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+static inline void __wav_wr32(FILE *f, uint32_t v){
+    uint8_t b[4] = {v, v >> 8, v >> 16, v >> 24};
+    fwrite(b, 1, 4, f);
+}
+
+static inline void __wav_wr16(FILE *f, uint16_t v){
+    uint8_t b[2] = {v, v >> 8};
+    fwrite(b, 1, 2, f);
+}
+
+/**
+ * @brief create the file and write the header, the sizes are
+ * written by wav_close()
+ */
+static inline FILE *wav_open(const char *path, uint32_t sampleRate){
+    FILE *f = fopen(path, "wb");
+
+    if (f == NULL){
+        return NULL;
+    }
+    fwrite("RIFF", 1, 4, f);
+    __wav_wr32(f, 0);
+    fwrite("WAVEfmt ", 1, 8, f);
+    __wav_wr32(f, 16);
+    __wav_wr16(f, 1);
+    __wav_wr16(f, 1);
+    __wav_wr32(f, sampleRate);
+    __wav_wr32(f, sampleRate * 2);
+    __wav_wr16(f, 2);
+    __wav_wr16(f, 16);
+    fwrite("data", 1, 4, f);
+    __wav_wr32(f, 0);
+
+    return f;
+}
+
+static inline void wav_write(FILE *f, const int16_t *samples, uint32_t len){
+    uint32_t i;
+
+    for (i = 0 ; i < len ; i++){
+        __wav_wr16(f, (uint16_t)samples[i]);
+    }
+}
+
+static inline void wav_close(FILE *f){
+    long size = ftell(f);
+
+    fseek(f, 4, SEEK_SET);
+    __wav_wr32(f, size - 8);
+    fseek(f, 40, SEEK_SET);
+    __wav_wr32(f, size - 44);
+    fclose(f);
+}
+
+#endif /* TOOLS_WAV_H_ */